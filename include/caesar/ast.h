@@ -9,9 +9,11 @@
 #define CAESAR_AST_H
 
 #include "caesar/token.h"
+#include "caesar/string_object.h"
 #include <memory>
 #include <vector>
 #include <string>
+#include <cstdint>
 
 namespace caesar {
 
@@ -66,6 +68,7 @@ public:
     virtual void visit(class UnaryExpression& node) = 0;
     virtual void visit(class CallExpression& node) = 0;
     virtual void visit(class MemberExpression& node) = 0;
+    virtual void visit(class IndexExpression& node) = 0;
     virtual void visit(class AssignmentExpression& node) = 0;
     virtual void visit(class ListExpression& node) = 0;
     virtual void visit(class DictExpression& node) = 0;
@@ -93,27 +96,85 @@ public:
 class LiteralExpression : public Expression {
 public:
     Token value;
+    String interned_value;  ///< Interned text of string-like literals
     
-    explicit LiteralExpression(const Token& val) : value(val) {}
+    explicit LiteralExpression(const Token& val)
+        : value(val),
+          interned_value(val.type == TokenType::INTEGER || val.type == TokenType::FLOAT
+                         ? String() : String::intern(val.value)) {}
     
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
 };
 
+/**
+ * @brief Where a variable lives, decided by the Resolver
+ */
+enum class VariableKind : uint8_t {
+    NAME,     ///< Looked up by name: globals, builtins, code outside functions
+    LOCAL,    ///< Register of the running function
+    CELL,     ///< Register holding a cell shared with nested functions
+    UPVALUE   ///< Cell captured by the running function when it was defined
+};
+
 /**
  * @brief Identifier expression (variable/function names)
  */
 class IdentifierExpression : public Expression {
 public:
     std::string name;
+    String symbol;                         ///< Interned name used for environment lookups
+    VariableKind kind = VariableKind::NAME;
+    int32_t slot = -1;                     ///< Register or upvalue index, depending on kind
+    std::vector<int32_t> fallbacks;        ///< Upvalues read while the slot is unbound, innermost first
+    String builtin_reference;              ///< "__builtin_<name>" if the name is a builtin
+    bool builtin_checked = false;          ///< builtin_reference has been looked up
     Position position;
     
-    IdentifierExpression(const std::string& n, const Position& pos) : name(n), position(pos) {}
+    IdentifierExpression(const std::string& n, const Position& pos)
+        : name(n), symbol(String::intern(n)), position(pos) {}
     
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
 };
 
+/**
+ * @brief Operand types a binary expression has been specialized for
+ *
+ * The interpreter records the operand types seen at each binary node and
+ * rewrites the node to a type-specialized handler. A failed guard falls
+ * back to the generic path.
+ */
+enum class BinarySpecialization : uint8_t {
+    UNSPECIALIZED,  ///< Not evaluated yet
+    INT_INT,        ///< int op int
+    FLOAT_FLOAT,    ///< float op float
+    NUMERIC,        ///< Mixed int and float operands
+    STRING_STRING,  ///< str op str
+    GENERIC         ///< Polymorphic site, always uses the generic path
+};
+
+/**
+ * @brief Handlers of specialized binary nodes, one per operand types and operator
+ *
+ * Listed once so the interpreter can build its dispatch table in the same
+ * order. NONE re-specializes; GENERIC takes the generic path.
+ */
+#define CAESAR_BINARY_HANDLERS(X) \
+    X(NONE) X(GENERIC) \
+    X(INT_ADD) X(INT_SUBTRACT) X(INT_MULTIPLY) X(INT_DIVIDE) X(INT_MODULO) \
+    X(INT_EQUAL) X(INT_NOT_EQUAL) X(INT_LESS) X(INT_LESS_EQUAL) X(INT_GREATER) X(INT_GREATER_EQUAL) \
+    X(FLOAT_ADD) X(FLOAT_SUBTRACT) X(FLOAT_MULTIPLY) X(FLOAT_DIVIDE) \
+    X(FLOAT_EQUAL) X(FLOAT_NOT_EQUAL) X(FLOAT_LESS) X(FLOAT_LESS_EQUAL) X(FLOAT_GREATER) \
+    X(FLOAT_GREATER_EQUAL) \
+    X(NUMERIC) X(STRING)
+
+enum class BinaryHandler : uint8_t {
+#define CAESAR_BINARY_HANDLER_ENUM(name) name,
+    CAESAR_BINARY_HANDLERS(CAESAR_BINARY_HANDLER_ENUM)
+#undef CAESAR_BINARY_HANDLER_ENUM
+};
+
 /**
  * @brief Binary expression (a + b, a == b, etc.)
  */
@@ -122,6 +183,9 @@ public:
     std::unique_ptr<Expression> left;
     TokenType operator_type;
     std::unique_ptr<Expression> right;
+    BinarySpecialization specialization = BinarySpecialization::UNSPECIALIZED;  ///< Runtime type feedback
+    BinaryHandler handler = BinaryHandler::NONE;  ///< Chosen with specialization for operator_type
+    uint8_t deopt_count = 0;  ///< Number of guard failures seen so far
     
     BinaryExpression(std::unique_ptr<Expression> l, TokenType op, std::unique_ptr<Expression> r, const Position& pos = Position())
         : Expression(pos), left(std::move(l)), operator_type(op), right(std::move(r)) {}
@@ -175,6 +239,21 @@ public:
     std::string toString() const override;
 };
 
+/**
+ * @brief Index expression (obj[index])
+ */
+class IndexExpression : public Expression {
+public:
+    std::unique_ptr<Expression> object;
+    std::unique_ptr<Expression> index;
+    
+    IndexExpression(std::unique_ptr<Expression> obj, std::unique_ptr<Expression> idx, const Position& pos = Position())
+        : Expression(pos), object(std::move(obj)), index(std::move(idx)) {}
+    
+    void accept(ASTVisitor& visitor) override;
+    std::string toString() const override;
+};
+
 /**
  * @brief Assignment expression
  */
@@ -287,11 +366,15 @@ public:
 class ForStatement : public Statement {
 public:
     std::string variable;
+    String variable_symbol;                         ///< Interned loop variable name
+    VariableKind variable_kind = VariableKind::NAME;
+    int32_t variable_slot = -1;                     ///< Register of the loop variable
     std::unique_ptr<Expression> iterable;
     std::unique_ptr<Statement> body;
     
     ForStatement(const std::string& var, std::unique_ptr<Expression> iter, std::unique_ptr<Statement> body_stmt, const Position& pos = Position())
-        : Statement(pos), variable(var), iterable(std::move(iter)), body(std::move(body_stmt)) {}
+        : Statement(pos), variable(var), variable_symbol(String::intern(var)),
+          iterable(std::move(iter)), body(std::move(body_stmt)) {}
     
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
@@ -302,18 +385,21 @@ public:
  */
 struct Parameter {
     std::string name;
+    String symbol;  ///< Interned parameter name
     std::unique_ptr<Expression> default_value; // nullptr if no default
     
     Parameter(const std::string& param_name, std::unique_ptr<Expression> default_val = nullptr)
-        : name(param_name), default_value(std::move(default_val)) {}
+        : name(param_name), symbol(String::intern(param_name)), default_value(std::move(default_val)) {}
     
     // Move constructor
     Parameter(Parameter&& other) noexcept 
-        : name(std::move(other.name)), default_value(std::move(other.default_value)) {}
+        : name(std::move(other.name)), symbol(std::move(other.symbol)),
+          default_value(std::move(other.default_value)) {}
     
     // Move assignment
     Parameter& operator=(Parameter&& other) noexcept {
         name = std::move(other.name);
+        symbol = std::move(other.symbol);
         default_value = std::move(other.default_value);
         return *this;
     }
@@ -323,6 +409,15 @@ struct Parameter {
     Parameter& operator=(const Parameter&) = delete;
 };
 
+/**
+ * @brief Cell a function captures from the function it is defined in
+ */
+struct UpvalueDescriptor {
+    String name;
+    bool from_parent_local;  ///< Parent's register (true) or one of the parent's upvalues
+    uint32_t index;          ///< Register or upvalue index in the parent
+};
+
 /**
  * @brief Function definition
  */
@@ -332,6 +427,14 @@ public:
     std::vector<Parameter> parameters;
     std::unique_ptr<Statement> body;
     
+    // Filled in by the Resolver before the function is first defined
+    bool resolved = false;
+    std::vector<String> slot_names;          ///< Local names by register, parameters first
+    std::vector<uint32_t> cell_slots;        ///< Registers captured by nested functions
+    std::vector<UpvalueDescriptor> upvalues; ///< Cells to capture when the def runs
+    VariableKind name_kind = VariableKind::NAME;
+    int32_t name_slot = -1;                  ///< Register of this function's name in its enclosing function
+    
     FunctionDefinition(const std::string& func_name, std::vector<Parameter> params, std::unique_ptr<Statement> body_stmt, const Position& pos = Position())
         : Statement(pos), name(func_name), parameters(std::move(params)), body(std::move(body_stmt)) {}
     
@@ -347,6 +450,8 @@ public:
     std::string name;
     std::vector<std::string> base_classes; // For inheritance (optional)
     std::unique_ptr<Statement> body;
+    VariableKind name_kind = VariableKind::NAME;
+    int32_t name_slot = -1;  ///< Register of the class name inside a function
     
     ClassDefinition(const std::string& class_name, std::vector<std::string> bases, std::unique_ptr<Statement> body_stmt, const Position& pos = Position())
         : Statement(pos), name(class_name), base_classes(std::move(bases)), body(std::move(body_stmt)) {}
@@ -361,9 +466,15 @@ public:
 class ReturnStatement : public Statement {
 public:
     std::unique_ptr<Expression> value; // nullable
+    bool is_tail_call;                 ///< value is a plain call f(...) in tail position
     
     ReturnStatement(std::unique_ptr<Expression> val, const Position& pos = Position())
-        : Statement(pos), value(std::move(val)) {}
+        : Statement(pos), value(std::move(val)), is_tail_call(false) {
+        // Method calls go through callMethod and are never user functions
+        if (auto call = dynamic_cast<CallExpression*>(value.get())) {
+            is_tail_call = dynamic_cast<MemberExpression*>(call->function.get()) == nullptr;
+        }
+    }
     
     void accept(ASTVisitor& visitor) override;
     std::string toString() const override;
@@ -0,0 +1,122 @@
+/**
+ * @file dict_object.h
+ * @brief Insertion-ordered open-addressing hash table for Caesar dicts
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_DICT_OBJECT_H
+#define CAESAR_DICT_OBJECT_H
+
+#include "caesar/gc.h"
+#include "caesar/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace caesar {
+
+/**
+ * @brief Mutable mapping backing Caesar dict values
+ *
+ * Uses the compact layout of CPython 3.6+: entries live in a dense array
+ * in insertion order, and a separate power-of-two index table of int32_t
+ * slots maps hashes to entry positions with linear probing. Iteration walks
+ * the dense array, and the sparse part of the table costs four bytes per
+ * slot instead of a whole entry.
+ *
+ * Removed entries stay in the dense array as tombstones until the next
+ * resize compacts it.
+ */
+class DictObject : public GcObject {
+public:
+    /**
+     * @brief Key/value pair stored in the dense entry array
+     */
+    struct Entry {
+        size_t hash;    ///< Cached hash of key
+        Value key;
+        Value value;
+        bool live;      ///< False once the entry has been removed
+    };
+
+private:
+    static constexpr int32_t EMPTY_SLOT = -1;    ///< Never used
+    static constexpr int32_t DELETED_SLOT = -2;  ///< Previously used, keep probing
+
+    std::vector<int32_t> indices_;   ///< Hash table of positions into entries_
+    std::vector<Entry> entries_;     ///< Entries in insertion order
+    size_t size_ = 0;                ///< Number of live entries
+
+public:
+    DictObject() = default;
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Look up a key
+     * @return Pointer to the stored value, or nullptr if the key is absent
+     * @throws RuntimeError if the key is not hashable
+     */
+    const Value* find(const Value& key) const;
+    const Value* find(const String& key) const;
+    const Value* find(int64_t key) const;
+
+    /**
+     * @brief Insert or overwrite a key, keeping its original position
+     * @throws RuntimeError if the key is not hashable
+     */
+    void set(const Value& key, const Value& value);
+
+    /**
+     * @brief Remove a key
+     * @param removed Receives the removed value when non-null
+     * @return Whether the key was present
+     */
+    bool remove(const Value& key, Value* removed = nullptr);
+
+    /**
+     * @brief Ensure room for count entries without resizing
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Dense entry array, including removed entries (check Entry::live)
+     */
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    void traverse(GcVisitor& visitor) const override;
+    void clearReferences() override;
+
+    /**
+     * @brief Hash a key consistently with keysEqual()
+     *
+     * Numbers that compare equal hash equally, so 1, 1.0 and True are the
+     * same key.
+     * @throws RuntimeError if the key is not hashable (lists, dicts)
+     */
+    static size_t hashKey(const Value& key);
+    static size_t hashInt(int64_t key);
+
+    static bool keysEqual(const Value& a, const Value& b);
+
+private:
+    /**
+     * @brief Probe for an entry whose hash matches and for which equal() holds
+     * @return Index into indices_ of the matching slot, or -1
+     */
+    template <typename Equal>
+    int64_t probe(size_t hash, Equal equal) const;
+
+    /**
+     * @brief Index of the first free slot on hash's probe sequence
+     */
+    size_t freeSlot(size_t hash) const;
+
+    void rebuild(size_t min_entries);
+};
+
+} // namespace caesar
+
+#endif // CAESAR_DICT_OBJECT_H
@@ -0,0 +1,161 @@
+/**
+ * @file execution_stats.h
+ * @brief Counters of interpreter activity reported by --stats
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_EXECUTION_STATS_H
+#define CAESAR_EXECUTION_STATS_H
+
+#include "caesar/ast.h"
+#include "caesar/interpreter.h"
+#include "caesar/token.h"
+#include "caesar/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <variant>
+
+namespace caesar {
+
+/**
+ * @brief AST node types, one per ASTVisitor::visit overload
+ */
+enum class NodeKind : uint8_t {
+    LITERAL,
+    IDENTIFIER,
+    BINARY,
+    UNARY,
+    CALL,
+    MEMBER,
+    INDEX,
+    ASSIGNMENT,
+    LIST,
+    DICT,
+    EXPRESSION_STATEMENT,
+    BLOCK,
+    IF,
+    WHILE,
+    FOR,
+    FUNCTION_DEFINITION,
+    CLASS_DEFINITION,
+    RETURN,
+    BREAK,
+    CONTINUE,
+    PASS,
+    PROGRAM,
+    COUNT
+};
+
+/**
+ * @brief What the interpreter executed, to find candidates for specialized nodes
+ *
+ * Counts visits per node type and pairs of consecutively visited node
+ * types, the tree-walking counterpart of an opcode pair histogram. Binary
+ * expressions also count their operand types per operator and the changes
+ * of their BinarySpecialization.
+ */
+class ExecutionStats {
+public:
+    static constexpr size_t NODE_KINDS = static_cast<size_t>(NodeKind::COUNT);
+    static constexpr size_t VALUE_TYPES = std::variant_size_v<Value>;
+    static constexpr size_t OPERATORS = static_cast<size_t>(TokenType::UNKNOWN) + 1;
+    static constexpr size_t SPECIALIZATIONS = static_cast<size_t>(BinarySpecialization::GENERIC) + 1;
+
+private:
+    uint64_t visits_[NODE_KINDS] = {};
+    uint64_t visit_pairs_[NODE_KINDS][NODE_KINDS] = {};
+    NodeKind previous_ = NodeKind::PROGRAM;
+    bool has_previous_ = false;
+
+    uint64_t binary_operands_[OPERATORS][VALUE_TYPES][VALUE_TYPES] = {};
+    uint64_t specializations_[SPECIALIZATIONS][SPECIALIZATIONS] = {};
+
+public:
+    void countVisit(NodeKind kind) {
+        size_t index = static_cast<size_t>(kind);
+        visits_[index]++;
+        if (has_previous_) visit_pairs_[static_cast<size_t>(previous_)][index]++;
+        previous_ = kind;
+        has_previous_ = true;
+    }
+
+    void countBinaryOperands(TokenType op, const Value& left, const Value& right) {
+        binary_operands_[static_cast<size_t>(op)][left.index()][right.index()]++;
+    }
+
+    void countSpecialization(BinarySpecialization from, BinarySpecialization to) {
+        specializations_[static_cast<size_t>(from)][static_cast<size_t>(to)]++;
+    }
+
+    uint64_t visits(NodeKind kind) const { return visits_[static_cast<size_t>(kind)]; }
+    uint64_t visitPairs(NodeKind first, NodeKind second) const {
+        return visit_pairs_[static_cast<size_t>(first)][static_cast<size_t>(second)];
+    }
+    uint64_t binaryOperands(TokenType op, size_t left_type, size_t right_type) const {
+        return binary_operands_[static_cast<size_t>(op)][left_type][right_type];
+    }
+    uint64_t specializations(BinarySpecialization from, BinarySpecialization to) const {
+        return specializations_[static_cast<size_t>(from)][static_cast<size_t>(to)];
+    }
+
+    /**
+     * @brief Print the counters as tables, most frequent first
+     *
+     * Only the top_pairs most frequent visit pairs are listed.
+     */
+    void printReport(std::ostream& out, size_t top_pairs = 20) const;
+
+    /**
+     * @brief Write all non-zero counters as one JSON object
+     */
+    void writeJson(std::ostream& out) const;
+
+    static const char* nodeKindName(NodeKind kind);
+    static const char* valueTypeName(size_t type_index);
+    static const char* specializationName(BinarySpecialization specialization);
+};
+
+/**
+ * @brief Interpreter that counts its node visits in an ExecutionStats
+ *
+ * Every node is entered through a virtual accept(), so overriding the
+ * visit methods sees all of them and a plain Interpreter pays nothing.
+ */
+class CountingInterpreter : public Interpreter {
+    ExecutionStats& stats_;
+
+public:
+    explicit CountingInterpreter(ExecutionStats& stats) : stats_(stats) {
+        setExecutionStats(&stats);
+    }
+
+    void visit(LiteralExpression& node) override;
+    void visit(IdentifierExpression& node) override;
+    void visit(BinaryExpression& node) override;
+    void visit(UnaryExpression& node) override;
+    void visit(CallExpression& node) override;
+    void visit(MemberExpression& node) override;
+    void visit(IndexExpression& node) override;
+    void visit(AssignmentExpression& node) override;
+    void visit(ListExpression& node) override;
+    void visit(DictExpression& node) override;
+
+    void visit(ExpressionStatement& node) override;
+    void visit(BlockStatement& node) override;
+    void visit(IfStatement& node) override;
+    void visit(WhileStatement& node) override;
+    void visit(ForStatement& node) override;
+    void visit(FunctionDefinition& node) override;
+    void visit(ClassDefinition& node) override;
+    void visit(ReturnStatement& node) override;
+    void visit(BreakStatement& node) override;
+    void visit(ContinueStatement& node) override;
+    void visit(PassStatement& node) override;
+    void visit(Program& node) override;
+};
+
+} // namespace caesar
+
+#endif // CAESAR_EXECUTION_STATS_H
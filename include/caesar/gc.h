@@ -0,0 +1,296 @@
+/**
+ * @file gc.h
+ * @brief Cycle collector for reference-counted runtime objects
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_GC_H
+#define CAESAR_GC_H
+
+#include "caesar/memory_pool.h"
+#include "caesar/ref.h"
+#include "caesar/value.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace caesar {
+
+class GcObject;
+
+/**
+ * @brief Receives each reference one GcObject holds to another
+ */
+class GcVisitor {
+public:
+    virtual ~GcVisitor() = default;
+    virtual void visit(GcObject* object) = 0;
+
+    /**
+     * @brief Visit the object a Value refers to, if it is a GcObject
+     */
+    void visitValue(const Value& value);
+};
+
+/**
+ * @brief Base of runtime objects that can take part in reference cycles
+ *
+ * Environments, functions, captured cells, lists and dicts derive from it.
+ * Every instance is linked into the GcHeap while it exists, and heap
+ * instances are allocated from the MemoryPool. Subclasses
+ * report the references they hold through traverse() and drop them in
+ * clearReferences(), which the collector calls to break a garbage cycle.
+ */
+class GcObject : public RefCounted, public Pooled {
+    friend class GcHeap;
+
+    GcObject* gc_prev = nullptr;
+    GcObject* gc_next = nullptr;
+    int64_t gc_refs = 0;         ///< Scratch count of references from outside the collected set
+    uint32_t gc_mark = 0;        ///< Epoch of the incremental cycle that last marked this object
+    uint8_t gc_generation = 0;   ///< YOUNG, OLD or COLLECTING
+    bool gc_reachable = false;   ///< Scratch mark of an atomic collection
+
+protected:
+    GcObject();
+    GcObject(const GcObject&) : GcObject() {}
+    GcObject& operator=(const GcObject&) { return *this; }
+
+public:
+    virtual ~GcObject();
+
+    /**
+     * @brief Call visitor.visit() once for every strong reference held
+     *
+     * Missing a reference only makes the collector more conservative, but
+     * reporting one that is not held lets it free live objects.
+     */
+    virtual void traverse(GcVisitor& visitor) const = 0;
+
+    /**
+     * @brief Release all references to other objects
+     */
+    virtual void clearReferences() = 0;
+};
+
+/**
+ * @brief Counters reported by --gc-stats
+ */
+struct GcStats {
+    uint64_t collections = 0;       ///< Young and full collections
+    uint64_t full_collections = 0;
+    uint64_t objects_freed = 0;
+    uint64_t objects_promoted = 0;  ///< Young objects that survived into the old generation
+    double total_pause_ms = 0.0;
+    double max_pause_ms = 0.0;
+    std::vector<float> pauses_us;   ///< Every pause, in order
+
+    /**
+     * @brief Pause at the given percentile (0-100), in microseconds
+     */
+    double pausePercentile(double percentile) const;
+};
+
+/**
+ * @brief Registry of all GcObjects and the collector that runs over them
+ *
+ * Reference counting frees everything except cycles. To find those, a
+ * collection uses trial deletion like CPython's gc module: start from each
+ * object's strong count, subtract the references coming from other
+ * objects being collected, and treat whatever is left over as a root. The
+ * roots are thus the objects referenced from outside: the interpreter's
+ * environment, frames and registers, and any C++ temporaries. Objects not
+ * reachable from a root are garbage; their references are cleared, which
+ * lets reference counting free them.
+ *
+ * Objects are kept in two generations. New objects start young, and most
+ * die young, so a young collection only looks at the young list and
+ * treats references from old objects as roots. Survivors are promoted to
+ * the old generation, which a full collection covers once it has grown by
+ * a quarter since the last full collection.
+ *
+ * With a pause budget set, full collections are incremental: see
+ * setMaxPause().
+ */
+class GcHeap {
+public:
+    static constexpr uint8_t YOUNG = 0;
+    static constexpr uint8_t OLD = 1;
+    static constexpr uint8_t COLLECTING = 2;  ///< Old, and swept into the latest incremental cycle
+
+private:
+    /// Live young objects that trigger a young collection
+    static constexpr size_t YOUNG_THRESHOLD = 10000;
+
+    /// Promotions that always allow a full collection, however small the old generation
+    static constexpr size_t MIN_FULL_THRESHOLD = 10000;
+
+    /// Steps of an incremental full collection
+    enum class Phase : uint8_t {
+        IDLE,      ///< No cycle running
+        COUNT,     ///< Take each object's strong count
+        SUBTRACT,  ///< Subtract references between collected objects
+        ROOTS,     ///< Mark objects with references from outside
+        MARK,      ///< Propagate marks from the roots
+        SWEEP      ///< Gather the unmarked objects as candidates
+    };
+
+    GcObject* first_[3] = {nullptr, nullptr, nullptr};  ///< Lists, indexed by generation
+    GcObject* last_[3] = {nullptr, nullptr, nullptr};   ///< List tails, for splicing
+    size_t count_[2] = {0, 0};                          ///< Young objects, old and collecting objects
+    size_t young_threshold_ = YOUNG_THRESHOLD;
+    size_t promoted_since_full_ = 0;
+    size_t old_after_full_ = 0;                         ///< Old generation size after the last full collection
+    bool collecting_ = false;
+    GcStats stats_;
+
+    // Incremental full collection
+    std::chrono::microseconds max_pause_{0};  ///< Zero: collect atomically
+    Phase phase_ = Phase::IDLE;
+    GcObject* cursor_ = nullptr;              ///< Next object of the COLLECTING list to visit
+    uint32_t epoch_ = 0;                      ///< gc_mark value of objects marked in this cycle
+    size_t old_after_slice_ = 0;              ///< Old generation size after the last slice
+    std::vector<Ref<GcObject>> gray_;        ///< Marked objects whose references are not visited yet
+    std::vector<Ref<GcObject>> candidates_;  ///< Unmarked objects found by SWEEP
+    std::vector<Ref<GcObject>> garbage_;     ///< Found by the last cycle, still to be cleared
+
+    /// Whether stores must be reported to shade(); see writeBarrier()
+    static inline bool marking_ = false;
+
+    GcHeap() = default;
+
+    void track(GcObject* object);
+    void untrack(GcObject* object);
+    void link(GcObject* object, uint8_t generation);
+    bool fullCollectionDue() const;
+    void adaptYoungThreshold(size_t collected, std::chrono::steady_clock::duration pause);
+    size_t fullCollect();
+
+    /**
+     * @brief Trial deletion over the objects of generation oldest or younger
+     * @return Number of objects freed
+     */
+    size_t collectGenerations(uint8_t oldest);
+
+    /**
+     * @brief Start an incremental cycle over the whole old generation
+     */
+    void startCycle();
+
+    /**
+     * @brief Advance the incremental cycle until it finishes or the deadline passes
+     * @param min_work Units of work to do even after the deadline
+     * @return Number of objects freed
+     */
+    size_t step(std::chrono::steady_clock::time_point deadline, size_t min_work);
+
+    /**
+     * @brief Free the candidates of the cycle after re-checking them atomically
+     * @return Number of objects freed
+     */
+    size_t finishCycle();
+
+    /**
+     * @brief Put the collected objects back into the old generation
+     */
+    void endCycle();
+
+    /**
+     * @brief Clear the references of the garbage found by the last cycle
+     * @param min_work Objects to clear even after the deadline
+     */
+    void clearGarbage(std::chrono::steady_clock::time_point deadline, size_t min_work);
+
+    void mark(GcObject* object);
+    void shade(GcObject* object);
+    void shadeValue(const Value& value);
+    void recordPause(std::chrono::steady_clock::time_point start);
+
+    friend class GcObject;
+
+public:
+    /**
+     * @brief The process-wide heap
+     *
+     * Deliberately leaked so it outlives objects destroyed during static
+     * destruction.
+     */
+    static GcHeap& instance();
+
+    /**
+     * @brief Collect if enough young objects have accumulated
+     *
+     * Only call this where no object is half-constructed.
+     */
+    void maybeCollect() {
+        if (count_[YOUNG] >= young_threshold_) collectYoung();
+    }
+
+    /**
+     * @brief Free unreachable young cycles and promote the survivors
+     *
+     * Runs a full collection instead when the old generation is due, or
+     * a slice of it in incremental mode.
+     * @return Number of objects freed
+     */
+    size_t collectYoung();
+
+    /**
+     * @brief Free all unreachable cycles now, abandoning any incremental cycle
+     * @return Number of objects freed
+     */
+    size_t collect();
+
+    /**
+     * @brief Bound the pause of each collection; zero collects atomically
+     *
+     * With a budget, a due full collection runs as an incremental cycle.
+     * Each young collection is followed by a slice of it that stops when
+     * the budget is used up. The young threshold adapts so that a young
+     * collection takes about half the budget.
+     *
+     * Between slices the program keeps mutating the heap, so the counts a
+     * cycle computes go stale. Write barriers mark any object stored into
+     * an environment, cell or container as live. At the end, the objects
+     * still unmarked are re-checked by trial deletion among themselves in
+     * one step, which is exact however stale the counts were. That step
+     * costs time in proportion to the garbage found, not the heap, and the
+     * garbage is then cleared over the following slices. A slice also does
+     * some work for every object the old generation grew by since the last
+     * one, even past the budget, so that a cycle ends before the program
+     * can outpace it. A single object is always traversed whole, so a huge
+     * list or dict can still cause one long slice.
+     */
+    void setMaxPause(std::chrono::microseconds budget);
+    std::chrono::microseconds getMaxPause() const { return max_pause_; }
+
+    /**
+     * @brief Write barrier for stores into runtime objects
+     *
+     * Only does work while an incremental cycle is marking.
+     */
+    static void writeBarrier(const Value& value) {
+        if (marking_) instance().shadeValue(value);
+    }
+    static void writeBarrier(GcObject* object) {
+        if (marking_ && object) instance().shade(object);
+    }
+
+    bool cycleInProgress() const { return phase_ != Phase::IDLE || !garbage_.empty(); }
+
+    size_t trackedCount() const { return count_[YOUNG] + count_[OLD]; }
+    size_t generationCount(uint8_t generation) const { return count_[generation == YOUNG ? YOUNG : OLD]; }
+    const GcStats& stats() const { return stats_; }
+
+    /**
+     * @brief Print the counters in the format of --gc-stats
+     */
+    void printStats(std::ostream& out) const;
+};
+
+} // namespace caesar
+
+#endif // CAESAR_GC_H
@@ -9,6 +9,13 @@
 #define CAESAR_INTERPRETER_H
 
 #include "caesar/ast.h"
+#include "caesar/value.h"
+#include "caesar/list_object.h"
+#include "caesar/dict_object.h"
+#include "caesar/gc.h"
+#include "caesar/profiler.h"
+#include "caesar/tracer.h"
+#include "caesar/small_vector.h"
 #include <variant>
 #include <functional>
 #include <cstdint>
@@ -23,32 +30,7 @@ namespace caesar {
 // Forward declarations
 class Interpreter;
 class Environment;
-
-/**
- * @brief Value type for runtime values (simplified for now)
- */
-using Value = std::variant<
-    std::nullptr_t,              // None/null
-    bool,                        // Boolean
-    int64_t,                     // Integer
-    double,                      // Float
-    std::string,                 // String
-    std::shared_ptr<class CallableFunction>  // User-defined functions
->;
-
-/**
- * @brief Runtime error class
- */
-class RuntimeError : public std::exception {
-public:
-    std::string message;
-    
-    RuntimeError(const std::string& msg) : message(msg) {}
-    
-    const char* what() const noexcept override {
-        return message.c_str();
-    }
-};
+class ExecutionStats;
 
 /**
  * @brief Control flow exceptions for break/continue/return
@@ -71,46 +53,128 @@ public:
     const char* what() const noexcept override { return "return"; }
 };
 
+/**
+ * @brief Arguments of a call; up to four are stored without heap allocation
+ */
+using ArgumentList = SmallVector<Value, 4>;
+
+/**
+ * @brief Heap box for a local captured by nested functions
+ *
+ * The register of the defining call and every closure capturing the local
+ * share the cell, so it outlives the call while the rest of the frame
+ * does not.
+ */
+struct Cell : public GcObject {
+    Value value = nullptr;
+    bool bound = false;  ///< False until the local is first assigned
+
+    void traverse(GcVisitor& visitor) const override { visitor.visitValue(value); }
+    void clearReferences() override { value = nullptr; }
+};
+
+/**
+ * @brief Storage for one local of a Caesar call
+ */
+struct Register {
+    Value value = nullptr;
+    bool bound = false;          ///< False until the local is first assigned
+    Ref<Cell> cell;  ///< Set instead of value for captured locals
+};
+
+/**
+ * @brief Activation record of a Caesar function call
+ *
+ * Frames live on the interpreter's heap-allocated frame stack, not in C++
+ * locals. A return statement stores its result in the innermost frame and
+ * sets Interpreter::returning, and the enclosing statements stop executing
+ * until control is back in CallableFunction::call. No exception is thrown.
+ */
+struct CallFrame {
+    const CallableFunction* function;                 ///< Function being executed
+    Environment* caller_environment;                  ///< Restored on return
+    Value return_value;                               ///< Set by return
+    Ref<CallableFunction> tail_function;              ///< Set by return f(...): run f in this frame
+    ArgumentList tail_arguments;                      ///< Arguments for tail_function
+    size_t register_base;                             ///< First register of this call's locals
+    const Statement* caller_statement;                ///< Restored on return, for the profiler
+};
+
 /**
  * @brief Environment for variable scoping
  */
-class Environment {
+class Environment : public GcObject {
 private:
-    std::shared_ptr<Environment> parent;
-    std::unordered_map<std::string, Value> variables;
+    /// Scopes with more variables than this also keep a hash index
+    static constexpr size_t INDEX_THRESHOLD = 8;
+
+    Ref<Environment> parent;
+    std::vector<std::pair<String, Value>> variables;      ///< Keyed by interned names
+    std::unordered_map<String, size_t, StringHash> index;  ///< Positions in variables, large scopes only
+
+    Value* lookup(const String& name);
 
 public:
-    Environment(std::shared_ptr<Environment> parent_env = nullptr)
+    Environment(Ref<Environment> parent_env = nullptr)
         : parent(parent_env) {}
 
-    void define(const std::string& name, const Value& value);
-    Value get(const std::string& name);
-    void assign(const std::string& name, const Value& value);
-    bool exists(const std::string& name);
+    void define(const String& name, const Value& value);
+    Value get(const String& name);
+    void assign(const String& name, const Value& value);
+    bool exists(const String& name);
+
+    void traverse(GcVisitor& visitor) const override;
+    void clearReferences() override;
 };
 
 /**
  * @brief Callable function class
  */
-class CallableFunction {
+class CallableFunction : public GcObject {
 private:
-    std::shared_ptr<FunctionDefinition> declaration;
-    std::shared_ptr<Environment> closure;
+    FunctionDefinition* declaration;  ///< Owned by the program's AST, which outlives its functions
+    Ref<Environment> closure;
+    std::vector<Ref<Cell>> upvalues;  ///< Captured locals, see FunctionDefinition::upvalues
 
 public:
-    CallableFunction(std::shared_ptr<FunctionDefinition> decl, std::shared_ptr<Environment> env)
-        : declaration(decl), closure(env) {}
+    CallableFunction(FunctionDefinition* decl, Ref<Environment> env)
+        : declaration(decl), closure(std::move(env)) {}
+
+    /**
+     * @brief Run the function; the arguments are moved into its registers
+     */
+    Value call(Interpreter& interpreter, ArgumentList&& arguments);
+
+    void addUpvalue(Ref<Cell> cell) {
+        GcHeap::writeBarrier(cell.get());
+        upvalues.push_back(std::move(cell));
+    }
+    const Ref<Cell>& getUpvalue(size_t index) const { return upvalues[index]; }
+    size_t getUpvalueCount() const { return upvalues.size(); }
+
+    void traverse(GcVisitor& visitor) const override;
+    void clearReferences() override;
 
-    Value call(Interpreter& interpreter, const std::vector<Value>& arguments);
+private:
+    /**
+     * @brief Set up the locals of a call starting at register_base
+     *
+     * Parameters are bound to the first registers, and captured locals get
+     * a fresh cell. Arguments are moved out of the list. The call runs in
+     * the closure environment.
+     */
+    void bindArguments(Interpreter& interpreter, ArgumentList& arguments, size_t register_base) const;
+
+public:
     
-    std::shared_ptr<FunctionDefinition> getDeclaration() const { return declaration; }
-    std::shared_ptr<Environment> getClosure() const { return closure; }
+    FunctionDefinition* getDeclaration() const { return declaration; }
+    const Ref<Environment>& getClosure() const { return closure; }
 };
 
 /**
  * @brief Built-in function type
  */
-using BuiltinFunction = std::function<Value(const std::vector<Value>&)>;
+using BuiltinFunction = std::function<Value(const ArgumentList&)>;
 
 /**
  * @brief Main interpreter class
@@ -119,14 +183,92 @@ class Interpreter : public ASTVisitor {
     friend class CallableFunction;  // Allow access to environment
     
 private:
-    std::shared_ptr<Environment> environment;
-    std::unordered_map<std::string, BuiltinFunction> builtins;
+    Ref<Environment> globals;
+    Environment* environment;  ///< Running code's environment, kept alive by globals or the running function
+    std::unordered_map<String, BuiltinFunction, StringHash> builtins;
+    /// A builtin as the value its name evaluates to refers to it
+    struct BuiltinReference {
+        const BuiltinFunction* function;
+        String name;  ///< Without the "__builtin_" prefix, for the profiler and tracer
+    };
+    /// Builtins by their interned "__builtin_<name>" reference string
+    std::unordered_map<String, BuiltinReference, StringHash> builtin_references;
     
     Value last_value;
+    
+    std::vector<CallFrame> frames;  ///< Active Caesar calls, innermost last
+    bool returning = false;         ///< A return is unwinding to the innermost frame
+    size_t max_recursion;           ///< Maximum length of frames
+    
+    std::vector<Register> registers;  ///< Locals of all active register-using calls
+    size_t register_base = 0;         ///< First register of the innermost call
+    
+    const Statement* current_statement = nullptr;  ///< Innermost statement started, for the profiler
+    SamplingProfiler* profiler = nullptr;
+    FunctionProfiler* function_profiler = nullptr;
+    Tracer* tracer = nullptr;
+    bool observing_calls = false;  ///< function_profiler or tracer is set
+    ExecutionStats* execution_stats = nullptr;
+    std::vector<ProfileFrame> sample_stack;        ///< Reused by sampleStack()
+    std::vector<const void*> printing;             ///< Containers valueToString() is inside
 
 public:
+    /// Default call depth limit, see setMaxRecursion()
+    static constexpr size_t DEFAULT_MAX_RECURSION = 10000;
+
     Interpreter();
-    ~Interpreter() = default;
+    ~Interpreter();
+
+    /**
+     * @brief Limit the number of nested Caesar calls
+     *
+     * Exceeding the limit raises a RuntimeError. interpret() sizes the
+     * native stack it runs on from this limit, so any depth up to it is
+     * safe regardless of the process stack size.
+     */
+    void setMaxRecursion(size_t depth) { max_recursion = depth; }
+    size_t getMaxRecursion() const { return max_recursion; }
+
+    /**
+     * @brief Number of active Caesar function calls
+     */
+    size_t getCallDepth() const { return frames.size(); }
+
+    /**
+     * @brief Record the Caesar call stack into profiler at each timer tick
+     *
+     * The profiler must stay alive while the interpreter runs; pass
+     * nullptr to detach it.
+     */
+    void setProfiler(SamplingProfiler* sampler) { profiler = sampler; }
+
+    /**
+     * @brief Count and time every Caesar function and builtin call in timer
+     *
+     * Like setProfiler(), timer must outlive the run; nullptr detaches it.
+     */
+    void setFunctionProfiler(FunctionProfiler* timer) {
+        function_profiler = timer;
+        observing_calls = function_profiler || tracer;
+    }
+
+    /**
+     * @brief Record every Caesar function and builtin call, and optionally loops, in trace
+     *
+     * Like setProfiler(), trace must outlive the run; nullptr detaches it.
+     */
+    void setTracer(Tracer* trace) {
+        tracer = trace;
+        observing_calls = function_profiler || tracer;
+    }
+
+    /**
+     * @brief Count binary operand types and specializations in stats
+     *
+     * Node visits are counted by CountingInterpreter, which calls this.
+     * Like setProfiler(), stats must outlive the run.
+     */
+    void setExecutionStats(ExecutionStats* stats) { execution_stats = stats; }
 
     /**
      * @brief Interpret a complete program
@@ -136,10 +278,10 @@ public:
     /**
      * @brief Get current environment
      */
-    std::shared_ptr<Environment> getCurrentEnvironment() const;
+    Ref<Environment> getCurrentEnvironment() const;
 
     /**
-     * @brief Evaluate an expression
+     * @brief Evaluate an expression, taking its value out of last_value
      */
     Value evaluate(Expression* expr);
 
@@ -150,6 +292,7 @@ public:
     void visit(UnaryExpression& node) override;
     void visit(CallExpression& node) override;
     void visit(MemberExpression& node) override;
+    void visit(IndexExpression& node) override;
     void visit(AssignmentExpression& node) override;
     void visit(ListExpression& node) override;
     void visit(DictExpression& node) override;
@@ -174,6 +317,63 @@ private:
      */
     void initializeBuiltins();
 
+    /**
+     * @brief Hand the stack to the profiler if a timer tick arrived
+     *
+     * Called after each statement and before each return.
+     */
+    void pollProfiler() {
+        if (SamplingProfiler::ticksPending() && profiler) sampleStack();
+    }
+
+    /**
+     * @brief Record the running Caesar call stack, outermost frame first
+     */
+    void sampleStack();
+
+    /**
+     * @brief Record operand types at a binary node and pick its specialized handler
+     */
+    void specializeBinary(BinaryExpression& node, const Value& left, const Value& right);
+
+    /**
+     * @brief Evaluate a binary operation without type feedback
+     */
+    void evaluateBinaryGeneric(TokenType op, const Value& left, const Value& right);
+
+    /**
+     * @brief Bind a local in its register or cell if it has one, else in the environment
+     */
+    void defineVariable(VariableKind kind, int32_t slot, const String& name, const Value& value);
+
+    /**
+     * @brief Call a user-defined or builtin function value
+     */
+    Value callValue(const Value& callee, ArgumentList&& arguments);
+
+    /**
+     * @brief callValue() reporting to the function profiler and tracer
+     *
+     * Kept out of callValue() so the unobserved path stays small.
+     */
+    Value callObserved(const Value& callee, ArgumentList&& arguments);
+
+    /**
+     * @brief Tell the function profiler and tracer that a call starts or ends
+     */
+    void beginObservedCall(const void* key, std::string_view name, TraceCategory category);
+    void endObservedCall(TraceCategory category);
+
+    /**
+     * @brief The builtin a "__builtin_<name>" callee refers to, or nullptr
+     */
+    const BuiltinReference* findBuiltin(const Value& callee) const;
+
+    /**
+     * @brief Call a method on a runtime object (list.append, list.pop, ...)
+     */
+    Value callMethod(const Value& object, const std::string& name, const ArgumentList& arguments);
+
     /**
      * @brief Convert value to string representation
      */
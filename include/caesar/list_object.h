@@ -0,0 +1,91 @@
+/**
+ * @file list_object.h
+ * @brief Runtime list with type-specialized storage strategies
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_LIST_OBJECT_H
+#define CAESAR_LIST_OBJECT_H
+
+#include "caesar/gc.h"
+#include "caesar/value.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace caesar {
+
+/**
+ * @brief Mutable sequence backing Caesar list values
+ *
+ * Elements are stored unboxed while the list is homogeneous: a list of
+ * ints is a contiguous int64_t array and a list of floats a contiguous
+ * double array. The first insert of a different type promotes the list
+ * to generic Value storage for the rest of its life (or until it is
+ * emptied).
+ */
+class ListObject : public GcObject {
+public:
+    /**
+     * @brief Storage strategy currently used by the list
+     */
+    enum class Storage : uint8_t {
+        EMPTY,    ///< No elements, strategy chosen by the first insert
+        INT,      ///< int64_t elements
+        FLOAT,    ///< double elements
+        GENERIC   ///< Arbitrary Value elements
+    };
+
+private:
+    Storage storage_ = Storage::EMPTY;
+    std::vector<int64_t> ints_;
+    std::vector<double> floats_;
+    std::vector<Value> values_;
+
+public:
+    ListObject() = default;
+
+    Storage storage() const { return storage_; }
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Convert a Python-style (possibly negative) index to an offset
+     * @throws RuntimeError if the index is out of range
+     */
+    size_t normalizeIndex(int64_t index) const;
+
+    Value get(size_t index) const;
+    void set(size_t index, const Value& value);
+    void append(const Value& value);
+    void reserve(size_t capacity);
+
+    /**
+     * @brief Remove and return the element at index
+     * @throws RuntimeError if the list is empty
+     */
+    Value pop(size_t index);
+
+    /**
+     * @brief Unboxed element arrays, valid only for the matching strategy
+     */
+    const int64_t* intData() const { return ints_.data(); }
+    const double* floatData() const { return floats_.data(); }
+
+    void traverse(GcVisitor& visitor) const override;
+    void clearReferences() override;
+
+private:
+    /**
+     * @brief Whether value can be stored without leaving the current strategy
+     */
+    bool fits(const Value& value) const;
+
+    void adoptStrategyFor(const Value& value);
+    void promoteToGeneric();
+};
+
+} // namespace caesar
+
+#endif // CAESAR_LIST_OBJECT_H
@@ -0,0 +1,151 @@
+/**
+ * @file memory_pool.h
+ * @brief Size-class pool allocator for runtime objects
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_MEMORY_POOL_H
+#define CAESAR_MEMORY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <new>
+#include <vector>
+
+namespace caesar {
+
+/**
+ * @brief Counters of one size class, reported by --mem-stats
+ */
+struct MemoryClassStats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+
+    uint64_t liveBlocks() const { return allocations - frees; }
+};
+
+/**
+ * @brief Allocator for the small, short-lived objects of the runtime
+ *
+ * Requests are rounded up to a multiple of GRANULE and served from the
+ * free list of that size class. A class with an empty free list carves
+ * blocks from a SLAB_SIZE slab of its own, so objects of one size sit
+ * together and a freed block is reused by the next object of that size.
+ * Slabs are kept in a list and never returned to the system. Requests
+ * above MAX_SMALL_SIZE go to global operator new and are only counted.
+ *
+ * Like the rest of the runtime this is single-threaded: the pool must
+ * only be used by the thread running the interpreter.
+ */
+class MemoryPool {
+public:
+    static constexpr size_t GRANULE = 16;
+    static constexpr size_t MAX_SMALL_SIZE = 256;
+    static constexpr size_t CLASS_COUNT = MAX_SMALL_SIZE / GRANULE;
+    static constexpr size_t SLAB_SIZE = 64 * 1024;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct SizeClass {
+        FreeBlock* free_list = nullptr;
+        char* bump = nullptr;       ///< Next unused block of the newest slab
+        char* bump_end = nullptr;
+        MemoryClassStats stats;
+    };
+
+    SizeClass classes_[CLASS_COUNT];
+    std::vector<char*> slabs_;  ///< Every slab allocated; keeps them reachable for leak checkers
+    MemoryClassStats large_stats_;
+    size_t large_live_bytes_ = 0;
+
+    MemoryPool() = default;
+
+    static size_t classIndex(size_t size) { return size == 0 ? 0 : (size - 1) / GRANULE; }
+
+    /**
+     * @brief Take a block from a fresh slab when the free list is empty
+     */
+    void* refill(SizeClass& size_class, size_t block_size);
+
+    void* allocateLarge(size_t size);
+    void deallocateLarge(void* memory, size_t size);
+
+public:
+    /**
+     * @brief The process-wide pool
+     *
+     * Deliberately leaked so it outlives objects destroyed during static
+     * destruction.
+     */
+    static MemoryPool& instance();
+
+    void* allocate(size_t size) {
+        if (size > MAX_SMALL_SIZE) return allocateLarge(size);
+
+        SizeClass& size_class = classes_[classIndex(size)];
+        size_class.stats.allocations++;
+        if (FreeBlock* block = size_class.free_list) {
+            size_class.free_list = block->next;
+            return block;
+        }
+        return refill(size_class, (classIndex(size) + 1) * GRANULE);
+    }
+
+    /**
+     * @brief Return a block; size must be the size it was allocated with
+     */
+    void deallocate(void* memory, size_t size) {
+        if (!memory) return;
+        if (size > MAX_SMALL_SIZE) {
+            deallocateLarge(memory, size);
+            return;
+        }
+
+        SizeClass& size_class = classes_[classIndex(size)];
+        size_class.stats.frees++;
+        FreeBlock* block = static_cast<FreeBlock*>(memory);
+        block->next = size_class.free_list;
+        size_class.free_list = block;
+    }
+
+    /**
+     * @brief Counters of the class serving requests of the given size
+     */
+    const MemoryClassStats& classStats(size_t size) const {
+        return size > MAX_SMALL_SIZE ? large_stats_ : classes_[classIndex(size)].stats;
+    }
+
+    /**
+     * @brief Bytes in blocks handed out and not yet returned
+     */
+    size_t liveBytes() const;
+
+    size_t slabBytes() const { return slabs_.size() * SLAB_SIZE; }
+
+    /**
+     * @brief Print the counters in the format of --mem-stats
+     */
+    void printStats(std::ostream& out) const;
+};
+
+/**
+ * @brief Base giving a class pooled operator new and delete
+ *
+ * Deleting through a base pointer needs a virtual destructor, which passes
+ * the size of the dynamic type to operator delete.
+ */
+struct Pooled {
+    static void* operator new(size_t size) { return MemoryPool::instance().allocate(size); }
+    static void operator delete(void* memory, size_t size) {
+        MemoryPool::instance().deallocate(memory, size);
+    }
+};
+
+} // namespace caesar
+
+#endif // CAESAR_MEMORY_POOL_H
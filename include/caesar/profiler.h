@@ -0,0 +1,170 @@
+/**
+ * @file profiler.h
+ * @brief Sampling profiler for Caesar source code
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_PROFILER_H
+#define CAESAR_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace caesar {
+
+class FunctionDefinition;
+
+/**
+ * @brief One Caesar frame of a sampled stack
+ */
+struct ProfileFrame {
+    const FunctionDefinition* function;  ///< nullptr for top-level code
+    size_t line;                         ///< Line running in this frame, 0 if unknown
+
+    bool operator==(const ProfileFrame& other) const {
+        return function == other.function && line == other.line;
+    }
+};
+
+/**
+ * @brief Samples the Caesar call stack on a CPU-time timer
+ *
+ * A SIGPROF timer only counts ticks; the signal handler cannot safely
+ * read the interpreter's frame vector while it may be reallocating. The
+ * interpreter polls ticksPending() after each statement and before each
+ * return, and records its stack with a weight of the ticks taken since.
+ * Time spent inside a builtin is thus charged to the calling line.
+ *
+ * Stacks refer to the AST, so the program must outlive writeFolded().
+ */
+class SamplingProfiler {
+public:
+    static constexpr int DEFAULT_FREQUENCY_HZ = 1000;
+
+private:
+    struct StackHash {
+        size_t operator()(const std::vector<ProfileFrame>& stack) const;
+    };
+
+    static inline std::atomic<uint32_t> pending_ticks_{0};
+
+    /// Samples per distinct stack, outermost frame first
+    std::unordered_map<std::vector<ProfileFrame>, uint64_t, StackHash> stacks_;
+    uint64_t samples_ = 0;
+    bool running_ = false;
+
+public:
+    SamplingProfiler() = default;
+    ~SamplingProfiler();
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    /**
+     * @brief Install the SIGPROF handler and start the timer
+     * @return False where setitimer() is unavailable or fails
+     */
+    bool start(int frequency_hz = DEFAULT_FREQUENCY_HZ);
+
+    /**
+     * @brief Stop the timer and ignore SIGPROF from then on
+     */
+    void stop();
+
+    /**
+     * @brief Count one timer tick, as the signal handler does
+     */
+    static void tick() { pending_ticks_.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Whether ticks arrived since the last sample, for the interpreter's polls
+     */
+    static bool ticksPending() { return pending_ticks_.load(std::memory_order_relaxed) != 0; }
+
+    /**
+     * @brief Record a stack for all pending ticks
+     */
+    void record(const std::vector<ProfileFrame>& stack);
+
+    uint64_t sampleCount() const { return samples_; }
+
+    /**
+     * @brief Write one "frame;frame;frame count" line per distinct stack
+     *
+     * This is the folded format of flamegraph.pl and speedscope. A frame
+     * is written as name:line, with <module> for top-level code.
+     */
+    void writeFolded(std::ostream& out) const;
+};
+
+/**
+ * @brief Call counts and times per Caesar function and builtin
+ *
+ * The interpreter brackets every call with enter() and exit(). Total time
+ * runs from entry to exit and counts a recursive function only at its
+ * outermost activation, so it never exceeds the wall time. Self time is
+ * total time minus the time spent in calls made from the function.
+ */
+class FunctionProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct FunctionStats {
+        std::string name;
+        uint64_t calls = 0;
+        uint64_t outermost_calls = 0;  ///< Calls not made from inside the function itself
+        Clock::duration total{0};
+        Clock::duration self{0};
+        uint32_t active = 0;  ///< Activations on the stack, for recursion
+    };
+
+private:
+    struct Activation {
+        FunctionStats* stats;
+        Clock::time_point start;
+        Clock::duration children;
+    };
+
+    std::unordered_map<const void*, FunctionStats> functions_;
+    std::vector<Activation> activations_;
+
+public:
+    /**
+     * @brief Start a call of the function identified by key
+     *
+     * name is only copied the first time key is seen.
+     */
+    void enter(const void* key, std::string_view name);
+
+    /**
+     * @brief End the innermost call
+     */
+    void exit();
+
+    /**
+     * @brief Functions called so far, sorted by descending self time
+     */
+    std::vector<const FunctionStats*> sortedStats() const;
+
+    /**
+     * @brief Print function, calls, total, self and time per outer call
+     *
+     * The last column, "us/outer call", is total time divided by outermost
+     * calls: the time a call from outside the function takes, including
+     * its recursion. It is not total divided by calls, which for a
+     * recursive function would spread one outer call over every level.
+     */
+    void printTable(std::ostream& out) const;
+};
+
+} // namespace caesar
+
+#endif // CAESAR_PROFILER_H
@@ -0,0 +1,153 @@
+/**
+ * @file ref.h
+ * @brief Intrusive, non-atomic reference counting for runtime objects
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_REF_H
+#define CAESAR_REF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace caesar {
+
+#ifdef CAESAR_REFCOUNT_STATS
+constexpr bool COUNT_REFCOUNT_OPERATIONS = true;
+#else
+constexpr bool COUNT_REFCOUNT_OPERATIONS = false;
+#endif
+
+/**
+ * @brief Reference count operations, only counted in CAESAR_REFCOUNT_STATS builds
+ */
+struct RefCountStats {
+    static inline uint64_t increments = 0;
+    static inline uint64_t decrements = 0;
+};
+
+/**
+ * @brief Base of objects owned through Ref handles
+ *
+ * The interpreter runs on one thread, so the count is a plain integer
+ * rather than the atomic one std::shared_ptr maintains. An object that no
+ * Ref has ever owned, such as one on the C++ stack, has a count of zero
+ * and is never deleted by a Ref.
+ */
+class RefCounted {
+    template <typename T> friend class Ref;
+
+    uint32_t refcount_ = 0;
+
+protected:
+    RefCounted() = default;
+    RefCounted(const RefCounted&) {}  // A copy is a new object with no owners
+    RefCounted& operator=(const RefCounted&) { return *this; }
+
+public:
+    virtual ~RefCounted() = default;
+
+    uint32_t refCount() const { return refcount_; }
+
+private:
+    void retain() {
+        ++refcount_;
+        if constexpr (COUNT_REFCOUNT_OPERATIONS) ++RefCountStats::increments;
+    }
+    void release() {
+        if constexpr (COUNT_REFCOUNT_OPERATIONS) ++RefCountStats::decrements;
+        if (--refcount_ == 0) delete this;
+    }
+};
+
+/**
+ * @brief Owning handle to a RefCounted object, like a non-atomic std::shared_ptr
+ *
+ * The handle stores the RefCounted base, so copying and destroying a Ref
+ * does not need T to be complete; only dereferencing it does. That lets
+ * Value hold handles to objects whose classes are defined after it.
+ */
+template <typename T>
+class Ref {
+    template <typename U> friend class Ref;
+
+    RefCounted* object_ = nullptr;
+
+public:
+    Ref() = default;
+    Ref(std::nullptr_t) {}
+
+    /**
+     * @brief Take a new reference to an existing object
+     */
+    explicit Ref(T* object) : object_(object) {
+        if (object_) object_->retain();
+    }
+
+    Ref(const Ref& other) : object_(other.object_) {
+        if (object_) object_->retain();
+    }
+    Ref(Ref&& other) noexcept : object_(other.object_) { other.object_ = nullptr; }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    Ref(const Ref<U>& other) : Ref(other.get()) {}
+
+    ~Ref() {
+        if (object_) object_->release();
+    }
+
+    Ref& operator=(const Ref& other) {
+        // Retain first, so assigning a handle to itself cannot free the object
+        if (other.object_) other.object_->retain();
+        RefCounted* old = object_;
+        object_ = other.object_;
+        if (old) old->release();
+        return *this;
+    }
+    Ref& operator=(Ref&& other) noexcept {
+        if (this != &other) {
+            RefCounted* old = object_;
+            object_ = other.object_;
+            other.object_ = nullptr;
+            if (old) old->release();
+        }
+        return *this;
+    }
+
+    T* get() const { return static_cast<T*>(object_); }
+    T* operator->() const { return get(); }
+    T& operator*() const { return *get(); }
+    explicit operator bool() const { return object_ != nullptr; }
+
+    void reset() {
+        RefCounted* old = object_;
+        object_ = nullptr;
+        if (old) old->release();
+    }
+
+    friend bool operator==(const Ref& a, const Ref& b) { return a.object_ == b.object_; }
+    friend bool operator!=(const Ref& a, const Ref& b) { return a.object_ != b.object_; }
+    friend bool operator==(const Ref& a, std::nullptr_t) { return a.object_ == nullptr; }
+    friend bool operator!=(const Ref& a, std::nullptr_t) { return a.object_ != nullptr; }
+
+    /**
+     * @brief Identity hash, for use as an unordered container key
+     */
+    size_t hash() const { return std::hash<const void*>()(object_); }
+};
+
+/**
+ * @brief Allocate an object owned by the returned handle, like std::make_shared
+ */
+template <typename T, typename... Args>
+Ref<T> makeRef(Args&&... args) {
+    return Ref<T>(new T(std::forward<Args>(args)...));
+}
+
+} // namespace caesar
+
+#endif // CAESAR_REF_H
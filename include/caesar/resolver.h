@@ -0,0 +1,97 @@
+/**
+ * @file resolver.h
+ * @brief Scope analysis assigning locals to registers and captures to upvalues
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_RESOLVER_H
+#define CAESAR_RESOLVER_H
+
+#include "caesar/ast.h"
+#include <cstddef>
+#include <vector>
+
+namespace caesar {
+
+/**
+ * @brief Escape analysis over function bodies
+ *
+ * The locals of a function are its parameters plus every name it assigns,
+ * loops over or defines a function or class as. They are numbered and kept
+ * in the frame's register file. Any other name a function reads is looked
+ * up in the enclosing functions, innermost first: if one of them declares
+ * it, the name becomes an upvalue that the closure captures when its def
+ * runs, and otherwise it is a global looked up by name.
+ *
+ * A read of a local or upvalue that has not been assigned yet falls back to
+ * the variables of that name in the enclosing functions, innermost first,
+ * and then to the globals. Those variables are captured as upvalues too.
+ *
+ * A local that some nested function captures is marked as a cell slot. Its
+ * register holds a heap cell shared with the closures instead of the value
+ * itself, so only those variables outlive the call, not the whole frame.
+ */
+class Resolver : public ASTVisitor {
+public:
+    /**
+     * @brief Analyze a function and every function nested inside it
+     */
+    static void resolve(FunctionDefinition& function);
+
+private:
+    /// One function being resolved, with the nodes bound to its registers
+    struct Scope {
+        std::vector<String> locals;
+        std::vector<bool> captured;
+        std::vector<UpvalueDescriptor> upvalues;
+        std::vector<IdentifierExpression*> identifiers;
+        std::vector<ForStatement*> loops;
+        std::vector<FunctionDefinition*> functions;
+        std::vector<ClassDefinition*> classes;
+    };
+
+    /// Enclosing functions, innermost last
+    std::vector<Scope*> scopes;
+
+    /// Declaring locals runs before resolving names, so later assignments count
+    bool collecting = false;
+
+    Resolver() = default;
+
+    void resolveFunction(FunctionDefinition& function);
+    void declare(const String& name);
+    int32_t declaringScope(size_t below, const String& name) const;
+    int32_t capture(size_t depth, size_t owner, const String& name);
+    void bindLocal(IdentifierExpression& identifier, bool reading);
+
+    // Expression visitors
+    void visit(LiteralExpression& node) override;
+    void visit(IdentifierExpression& node) override;
+    void visit(BinaryExpression& node) override;
+    void visit(UnaryExpression& node) override;
+    void visit(CallExpression& node) override;
+    void visit(MemberExpression& node) override;
+    void visit(IndexExpression& node) override;
+    void visit(AssignmentExpression& node) override;
+    void visit(ListExpression& node) override;
+    void visit(DictExpression& node) override;
+
+    // Statement visitors
+    void visit(ExpressionStatement& node) override;
+    void visit(BlockStatement& node) override;
+    void visit(IfStatement& node) override;
+    void visit(WhileStatement& node) override;
+    void visit(ForStatement& node) override;
+    void visit(FunctionDefinition& node) override;
+    void visit(ClassDefinition& node) override;
+    void visit(ReturnStatement& node) override;
+    void visit(BreakStatement& node) override;
+    void visit(ContinueStatement& node) override;
+    void visit(PassStatement& node) override;
+    void visit(Program& node) override;
+};
+
+} // namespace caesar
+
+#endif // CAESAR_RESOLVER_H
@@ -0,0 +1,139 @@
+/**
+ * @file small_vector.h
+ * @brief Vector with inline storage for a small number of elements
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_SMALL_VECTOR_H
+#define CAESAR_SMALL_VECTOR_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+namespace caesar {
+
+/**
+ * @brief Sequence that stores up to N elements without touching the heap
+ *
+ * Behaves like a minimal std::vector. Growing beyond N moves the elements
+ * to a heap buffer, which is kept until destruction.
+ */
+template <typename T, size_t N>
+class SmallVector {
+private:
+    T* data_;
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+
+    T* inlineData() { return reinterpret_cast<T*>(inline_); }
+    bool isInline() const { return data_ == reinterpret_cast<const T*>(inline_); }
+
+    void grow(size_t min_capacity) {
+        size_t capacity = capacity_ * 2;
+        if (capacity < min_capacity) capacity = min_capacity;
+
+        T* grown = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < size_; i++) {
+            new (grown + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        if (!isInline()) ::operator delete(data_);
+        data_ = grown;
+        capacity_ = capacity;
+    }
+
+public:
+    SmallVector() : data_(inlineData()) {}
+
+    SmallVector(std::initializer_list<T> items) : SmallVector() {
+        reserve(items.size());
+        for (const T& item : items) push_back(item);
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector() {
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; i++) push_back(other.data_[i]);
+    }
+
+    SmallVector(SmallVector&& other) noexcept : SmallVector() {
+        *this = std::move(other);
+    }
+
+    ~SmallVector() {
+        clear();
+        if (!isInline()) ::operator delete(data_);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (size_t i = 0; i < other.size_; i++) push_back(other.data_[i]);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        if (!other.isInline()) {
+            // Steal the heap buffer
+            if (!isInline()) ::operator delete(data_);
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inlineData();
+            other.size_ = 0;
+            other.capacity_ = N;
+        } else {
+            for (size_t i = 0; i < other.size_; i++) push_back(std::move(other.data_[i]));
+            other.clear();
+        }
+        return *this;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+
+    T& operator[](size_t index) { return data_[index]; }
+    const T& operator[](size_t index) const { return data_[index]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) grow(capacity);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) grow(size_ + 1);
+        new (data_ + size_) T(std::forward<Args>(args)...);
+        return data_[size_++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() { data_[--size_].~T(); }
+
+    void clear() {
+        for (size_t i = 0; i < size_; i++) data_[i].~T();
+        size_ = 0;
+    }
+};
+
+} // namespace caesar
+
+#endif // CAESAR_SMALL_VECTOR_H
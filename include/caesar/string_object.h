@@ -0,0 +1,150 @@
+/**
+ * @file string_object.h
+ * @brief Reference-counted runtime strings for the Caesar interpreter
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_STRING_OBJECT_H
+#define CAESAR_STRING_OBJECT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace caesar {
+
+/**
+ * @brief Character storage shared by strings built through concatenation
+ *
+ * A buffer is never reallocated. Strings sharing a buffer all start at
+ * its first byte and differ only in length, so the string covering the
+ * whole used prefix may append into the spare capacity without affecting
+ * the shorter strings that also view it.
+ */
+struct StringBuffer {
+    uint32_t refcount;  ///< Number of StringObjects viewing this buffer
+    size_t used;        ///< Bytes written so far
+    size_t capacity;    ///< Bytes allocated in data
+    char data[1];       ///< Character storage (over-allocated)
+
+    static StringBuffer* create(size_t capacity);
+    static void destroy(StringBuffer* buffer);
+    static void release(StringBuffer* buffer) {
+        if (--buffer->refcount == 0) destroy(buffer);
+    }
+};
+
+/**
+ * @brief Immutable string value referencing a prefix of a StringBuffer
+ */
+struct StringObject {
+    uint32_t refcount;      ///< Number of String handles referencing this object
+    bool interned;          ///< Canonical instance owned by the intern table
+    size_t length;          ///< Length in bytes
+    size_t hash;            ///< Cached hash, 0 until first computed
+    StringBuffer* buffer;   ///< Shared character storage
+
+    static StringObject* create(StringBuffer* buffer, size_t length);
+    static void destroy(StringObject* object);
+    static void release(StringObject* object) {
+        if (--object->refcount == 0) destroy(object);
+    }
+
+    /**
+     * @brief Shared empty string; its reference count never drops to zero
+     */
+    static StringObject* empty();
+};
+
+/**
+ * @brief Handle to a runtime string
+ *
+ * Copying a String copies a pointer and bumps a non-atomic reference
+ * count; the characters are never copied. Concatenation appends in place
+ * when the left operand ends at the tail of its buffer, which makes
+ * repeated `s = s + t` amortized O(len(t)).
+ *
+ * Identifiers and string literals are interned: there is one canonical
+ * object per distinct text, so two interned strings are equal exactly
+ * when they are the same object.
+ */
+class String {
+private:
+    StringObject* object_;
+
+    explicit String(StringObject* object) : object_(object) {}
+
+public:
+    String();
+    String(std::string_view text);
+    String(const std::string& text) : String(std::string_view(text)) {}
+    String(const char* text) : String(std::string_view(text)) {}
+
+    String(const String& other) : object_(other.object_) { ++object_->refcount; }
+    String(String&& other) noexcept : object_(other.object_) {
+        // Leave the source as a valid empty string
+        other.object_ = StringObject::empty();
+        ++other.object_->refcount;
+    }
+    ~String() { StringObject::release(object_); }
+
+    String& operator=(const String& other);
+    String& operator=(String&& other) noexcept;
+
+    size_t size() const { return object_->length; }
+    bool empty() const { return object_->length == 0; }
+    const char* data() const { return object_->buffer->data; }
+    std::string_view view() const { return std::string_view(data(), size()); }
+    std::string str() const { return std::string(data(), size()); }
+    bool isInterned() const { return object_->interned; }
+
+    /**
+     * @brief Hash of the characters, computed once and cached on the object
+     */
+    size_t hash() const { return object_->hash ? object_->hash : computeHash(); }
+
+    /**
+     * @brief Return the canonical interned string with the given text
+     */
+    static String intern(std::string_view text);
+
+    /**
+     * @brief Concatenate two strings, appending in place when possible
+     */
+    static String concat(const String& left, const String& right);
+
+    friend bool operator==(const String& a, const String& b);
+    friend bool operator<(const String& a, const String& b) { return a.view() < b.view(); }
+
+private:
+    size_t computeHash() const;
+};
+
+inline bool operator==(const String& a, const String& b) {
+    if (a.object_ == b.object_) return true;
+    if (a.object_->interned && b.object_->interned) return false;
+    if (a.object_->hash && b.object_->hash && a.object_->hash != b.object_->hash) return false;
+    return a.view() == b.view();
+}
+inline bool operator!=(const String& a, const String& b) { return !(a == b); }
+inline bool operator<=(const String& a, const String& b) { return !(b < a); }
+inline bool operator>(const String& a, const String& b) { return b < a; }
+inline bool operator>=(const String& a, const String& b) { return !(a < b); }
+
+/**
+ * @brief Hash functor using the cached string hash
+ */
+struct StringHash {
+    size_t operator()(const String& s) const { return s.hash(); }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const String& s) {
+    return os << s.view();
+}
+
+} // namespace caesar
+
+#endif // CAESAR_STRING_OBJECT_H
@@ -0,0 +1,119 @@
+/**
+ * @file tracer.h
+ * @brief Chrome trace-event recording of Caesar calls
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_TRACER_H
+#define CAESAR_TRACER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string_view>
+
+namespace caesar {
+
+enum class TraceCategory : uint8_t {
+    FUNCTION,
+    BUILTIN,
+    LOOP
+};
+
+/**
+ * @brief Records begin and end events of calls and loops for chrome://tracing
+ *
+ * Events go into a ring buffer allocated up front. Recording one is a
+ * clock read and a few stores, with no allocation and no lock; the
+ * interpreter is the only writer. Once the buffer is full the oldest
+ * events are overwritten, so a trace keeps the end of a long run.
+ *
+ * Names are not copied: they must stay valid until writeJson(). Function
+ * names live in the AST and builtin names are interned.
+ */
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 20;
+
+private:
+    /// Left uninitialized, so the buffer's pages are only committed as it fills
+    struct Event {
+        const char* name;
+        uint32_t name_length;
+        uint32_t line;  ///< Loops only
+        int64_t timestamp_ns;
+        char phase;     ///< 'B' or 'E'
+        TraceCategory category;
+    };
+
+    std::unique_ptr<Event[]> events_;
+    size_t mask_;
+    uint64_t recorded_ = 0;
+    std::chrono::steady_clock::time_point start_;
+    bool trace_loops_;
+
+    void record(char phase, std::string_view name, TraceCategory category, uint32_t line) {
+        Event& event = events_[recorded_++ & mask_];
+        event.name = name.data();
+        event.name_length = static_cast<uint32_t>(name.size());
+        event.line = line;
+        event.timestamp_ns = (std::chrono::steady_clock::now() - start_).count();
+        event.phase = phase;
+        event.category = category;
+    }
+
+public:
+    /**
+     * @param capacity Events kept, rounded up to a power of two
+     * @param trace_loops Also record each execution of a while or for loop
+     */
+    explicit Tracer(size_t capacity = DEFAULT_CAPACITY, bool trace_loops = false);
+
+    bool tracesLoops() const { return trace_loops_; }
+
+    void begin(std::string_view name, TraceCategory category, uint32_t line = 0) {
+        record('B', name, category, line);
+    }
+    /**
+     * @brief End the innermost slice; trace viewers match it by nesting, not by name
+     */
+    void end(TraceCategory category) { record('E', std::string_view(), category, 0); }
+
+    /**
+     * @brief Records a loop from construction to destruction; does nothing without a tracer
+     */
+    class LoopScope {
+        Tracer* tracer_;
+
+    public:
+        LoopScope(Tracer* tracer, std::string_view name, size_t line)
+            : tracer_(tracer && tracer->tracesLoops() ? tracer : nullptr) {
+            if (tracer_) tracer_->begin(name, TraceCategory::LOOP, static_cast<uint32_t>(line));
+        }
+        ~LoopScope() {
+            if (tracer_) tracer_->end(TraceCategory::LOOP);
+        }
+
+        LoopScope(const LoopScope&) = delete;
+        LoopScope& operator=(const LoopScope&) = delete;
+    };
+
+    size_t capacity() const { return mask_ + 1; }
+    uint64_t recordedCount() const { return recorded_; }
+    uint64_t droppedCount() const { return recorded_ > capacity() ? recorded_ - capacity() : 0; }
+
+    /**
+     * @brief Write the kept events in the Chrome Trace Event Format
+     *
+     * End events whose begin event was overwritten are skipped, so every
+     * slice in the output is complete.
+     */
+    void writeJson(std::ostream& out) const;
+};
+
+} // namespace caesar
+
+#endif // CAESAR_TRACER_H
@@ -0,0 +1,56 @@
+/**
+ * @file value.h
+ * @brief Runtime value representation for the Caesar interpreter
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_VALUE_H
+#define CAESAR_VALUE_H
+
+#include "caesar/ref.h"
+#include "caesar/string_object.h"
+#include <variant>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <exception>
+
+namespace caesar {
+
+// Forward declarations
+class CallableFunction;
+class ListObject;
+class DictObject;
+
+/**
+ * @brief Value type for runtime values (simplified for now)
+ */
+using Value = std::variant<
+    std::nullptr_t,              // None/null
+    bool,                        // Boolean
+    int64_t,                     // Integer
+    double,                      // Float
+    String,                      // String
+    Ref<CallableFunction>,       // User-defined functions
+    Ref<ListObject>,             // Lists
+    Ref<DictObject>              // Dicts
+>;
+
+/**
+ * @brief Runtime error class
+ */
+class RuntimeError : public std::exception {
+public:
+    std::string message;
+    
+    RuntimeError(const std::string& msg) : message(msg) {}
+    
+    const char* what() const noexcept override {
+        return message.c_str();
+    }
+};
+
+} // namespace caesar
+
+#endif // CAESAR_VALUE_H
@@ -0,0 +1,301 @@
+/**
+ * @file execution_stats.cpp
+ * @brief Counters of interpreter activity reported by --stats
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/execution_stats.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace caesar {
+
+namespace {
+
+std::string operatorName(size_t op) {
+    return Token(static_cast<TokenType>(op), "", Position()).typeToString();
+}
+
+struct Row {
+    std::string label;
+    uint64_t count;
+};
+
+void sortRows(std::vector<Row>& rows) {
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.count != b.count ? a.count > b.count : a.label < b.label;
+    });
+}
+
+void printRows(std::ostream& out, const char* title, const std::vector<Row>& rows, size_t limit) {
+    out << title << "\n";
+    for (size_t i = 0; i < rows.size() && i < limit; i++) {
+        out << "  " << std::left << std::setw(48) << rows[i].label << std::right
+            << std::setw(14) << rows[i].count << "\n";
+    }
+}
+
+} // anonymous namespace
+
+const char* ExecutionStats::nodeKindName(NodeKind kind) {
+    switch (kind) {
+        case NodeKind::LITERAL: return "LiteralExpression";
+        case NodeKind::IDENTIFIER: return "IdentifierExpression";
+        case NodeKind::BINARY: return "BinaryExpression";
+        case NodeKind::UNARY: return "UnaryExpression";
+        case NodeKind::CALL: return "CallExpression";
+        case NodeKind::MEMBER: return "MemberExpression";
+        case NodeKind::INDEX: return "IndexExpression";
+        case NodeKind::ASSIGNMENT: return "AssignmentExpression";
+        case NodeKind::LIST: return "ListExpression";
+        case NodeKind::DICT: return "DictExpression";
+        case NodeKind::EXPRESSION_STATEMENT: return "ExpressionStatement";
+        case NodeKind::BLOCK: return "BlockStatement";
+        case NodeKind::IF: return "IfStatement";
+        case NodeKind::WHILE: return "WhileStatement";
+        case NodeKind::FOR: return "ForStatement";
+        case NodeKind::FUNCTION_DEFINITION: return "FunctionDefinition";
+        case NodeKind::CLASS_DEFINITION: return "ClassDefinition";
+        case NodeKind::RETURN: return "ReturnStatement";
+        case NodeKind::BREAK: return "BreakStatement";
+        case NodeKind::CONTINUE: return "ContinueStatement";
+        case NodeKind::PASS: return "PassStatement";
+        case NodeKind::PROGRAM: return "Program";
+        default: return "Unknown";
+    }
+}
+
+const char* ExecutionStats::valueTypeName(size_t type_index) {
+    // In the order of the Value alternatives
+    static const char* const names[VALUE_TYPES] = {
+        "NoneType", "bool", "int", "float", "str", "function", "list", "dict"
+    };
+    return type_index < VALUE_TYPES ? names[type_index] : "unknown";
+}
+
+const char* ExecutionStats::specializationName(BinarySpecialization specialization) {
+    switch (specialization) {
+        case BinarySpecialization::UNSPECIALIZED: return "UNSPECIALIZED";
+        case BinarySpecialization::INT_INT: return "INT_INT";
+        case BinarySpecialization::FLOAT_FLOAT: return "FLOAT_FLOAT";
+        case BinarySpecialization::NUMERIC: return "NUMERIC";
+        case BinarySpecialization::STRING_STRING: return "STRING_STRING";
+        case BinarySpecialization::GENERIC: return "GENERIC";
+        default: return "UNKNOWN";
+    }
+}
+
+void ExecutionStats::printReport(std::ostream& out, size_t top_pairs) const {
+    std::vector<Row> visits;
+    std::vector<Row> pairs;
+    for (size_t i = 0; i < NODE_KINDS; i++) {
+        NodeKind first = static_cast<NodeKind>(i);
+        if (visits_[i] > 0) visits.push_back(Row{nodeKindName(first), visits_[i]});
+        for (size_t j = 0; j < NODE_KINDS; j++) {
+            if (visit_pairs_[i][j] == 0) continue;
+            pairs.push_back(Row{std::string(nodeKindName(first)) + " -> " +
+                                    nodeKindName(static_cast<NodeKind>(j)),
+                                visit_pairs_[i][j]});
+        }
+    }
+
+    std::vector<Row> operands;
+    for (size_t op = 0; op < OPERATORS; op++) {
+        for (size_t l = 0; l < VALUE_TYPES; l++) {
+            for (size_t r = 0; r < VALUE_TYPES; r++) {
+                if (binary_operands_[op][l][r] == 0) continue;
+                operands.push_back(Row{operatorName(op) + "(" + valueTypeName(l) + ", " +
+                                           valueTypeName(r) + ")",
+                                       binary_operands_[op][l][r]});
+            }
+        }
+    }
+
+    std::vector<Row> transitions;
+    for (size_t from = 0; from < SPECIALIZATIONS; from++) {
+        for (size_t to = 0; to < SPECIALIZATIONS; to++) {
+            if (specializations_[from][to] == 0) continue;
+            transitions.push_back(
+                Row{std::string(specializationName(static_cast<BinarySpecialization>(from))) +
+                        " -> " + specializationName(static_cast<BinarySpecialization>(to)),
+                    specializations_[from][to]});
+        }
+    }
+
+    sortRows(visits);
+    sortRows(pairs);
+    sortRows(operands);
+    sortRows(transitions);
+    printRows(out, "Node visits:", visits, visits.size());
+    printRows(out, "Consecutive node visits:", pairs, top_pairs);
+    printRows(out, "Binary operand types:", operands, operands.size());
+    printRows(out, "Binary specializations:", transitions, transitions.size());
+}
+
+void ExecutionStats::writeJson(std::ostream& out) const {
+    // Every name written is a fixed identifier, so nothing needs escaping
+    out << "{\n  \"visits\": {";
+    const char* separator = "";
+    for (size_t i = 0; i < NODE_KINDS; i++) {
+        if (visits_[i] == 0) continue;
+        out << separator << "\n    \"" << nodeKindName(static_cast<NodeKind>(i))
+            << "\": " << visits_[i];
+        separator = ",";
+    }
+
+    out << "\n  },\n  \"visit_pairs\": [";
+    separator = "";
+    for (size_t i = 0; i < NODE_KINDS; i++) {
+        for (size_t j = 0; j < NODE_KINDS; j++) {
+            if (visit_pairs_[i][j] == 0) continue;
+            out << separator << "\n    {\"first\": \"" << nodeKindName(static_cast<NodeKind>(i))
+                << "\", \"second\": \"" << nodeKindName(static_cast<NodeKind>(j))
+                << "\", \"count\": " << visit_pairs_[i][j] << "}";
+            separator = ",";
+        }
+    }
+
+    out << "\n  ],\n  \"binary_operands\": [";
+    separator = "";
+    for (size_t op = 0; op < OPERATORS; op++) {
+        for (size_t l = 0; l < VALUE_TYPES; l++) {
+            for (size_t r = 0; r < VALUE_TYPES; r++) {
+                if (binary_operands_[op][l][r] == 0) continue;
+                out << separator << "\n    {\"operator\": \"" << operatorName(op)
+                    << "\", \"left\": \"" << valueTypeName(l) << "\", \"right\": \""
+                    << valueTypeName(r) << "\", \"count\": " << binary_operands_[op][l][r] << "}";
+                separator = ",";
+            }
+        }
+    }
+
+    out << "\n  ],\n  \"binary_specializations\": [";
+    separator = "";
+    for (size_t from = 0; from < SPECIALIZATIONS; from++) {
+        for (size_t to = 0; to < SPECIALIZATIONS; to++) {
+            if (specializations_[from][to] == 0) continue;
+            out << separator << "\n    {\"from\": \""
+                << specializationName(static_cast<BinarySpecialization>(from)) << "\", \"to\": \""
+                << specializationName(static_cast<BinarySpecialization>(to))
+                << "\", \"count\": " << specializations_[from][to] << "}";
+            separator = ",";
+        }
+    }
+    out << "\n  ]\n}\n";
+}
+
+void CountingInterpreter::visit(LiteralExpression& node) {
+    stats_.countVisit(NodeKind::LITERAL);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(IdentifierExpression& node) {
+    stats_.countVisit(NodeKind::IDENTIFIER);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(BinaryExpression& node) {
+    stats_.countVisit(NodeKind::BINARY);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(UnaryExpression& node) {
+    stats_.countVisit(NodeKind::UNARY);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(CallExpression& node) {
+    stats_.countVisit(NodeKind::CALL);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(MemberExpression& node) {
+    stats_.countVisit(NodeKind::MEMBER);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(IndexExpression& node) {
+    stats_.countVisit(NodeKind::INDEX);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(AssignmentExpression& node) {
+    stats_.countVisit(NodeKind::ASSIGNMENT);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(ListExpression& node) {
+    stats_.countVisit(NodeKind::LIST);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(DictExpression& node) {
+    stats_.countVisit(NodeKind::DICT);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(ExpressionStatement& node) {
+    stats_.countVisit(NodeKind::EXPRESSION_STATEMENT);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(BlockStatement& node) {
+    stats_.countVisit(NodeKind::BLOCK);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(IfStatement& node) {
+    stats_.countVisit(NodeKind::IF);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(WhileStatement& node) {
+    stats_.countVisit(NodeKind::WHILE);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(ForStatement& node) {
+    stats_.countVisit(NodeKind::FOR);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(FunctionDefinition& node) {
+    stats_.countVisit(NodeKind::FUNCTION_DEFINITION);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(ClassDefinition& node) {
+    stats_.countVisit(NodeKind::CLASS_DEFINITION);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(ReturnStatement& node) {
+    stats_.countVisit(NodeKind::RETURN);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(BreakStatement& node) {
+    stats_.countVisit(NodeKind::BREAK);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(ContinueStatement& node) {
+    stats_.countVisit(NodeKind::CONTINUE);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(PassStatement& node) {
+    stats_.countVisit(NodeKind::PASS);
+    Interpreter::visit(node);
+}
+
+void CountingInterpreter::visit(Program& node) {
+    stats_.countVisit(NodeKind::PROGRAM);
+    Interpreter::visit(node);
+}
+
+} // namespace caesar
@@ -6,34 +6,283 @@
  */
 
 #include "caesar/interpreter.h"
+#include "caesar/execution_stats.h"
+#include "caesar/resolver.h"
 #include "caesar/token.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <exception>
+#include <functional>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define CAESAR_HAS_INTERPRETER_STACK 1
+#endif
+
+// Binary handlers are reached through a table of label addresses where the compiler allows it
+#if defined(CAESAR_THREADED_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+#define CAESAR_COMPUTED_GOTO 1
+#endif
 
 namespace caesar {
 
+namespace {
+
+/// Guard failures tolerated before a binary node stays on the generic path
+constexpr uint8_t MAX_BINARY_DEOPTS = 4;
+
+/// Native stack reserved per allowed Caesar call, with room for nested expressions
+constexpr size_t NATIVE_STACK_PER_CALL = 16 * 1024;
+
+/// Native stack reserved for top-level code and builtins
+constexpr size_t NATIVE_STACK_BASE = 8 * 1024 * 1024;
+
+#ifdef CAESAR_HAS_INTERPRETER_STACK
+struct StackedTask {
+    const std::function<void()>* task;
+    std::exception_ptr error;
+};
+
+void* runStackedTask(void* argument) {
+    auto stacked = static_cast<StackedTask*>(argument);
+    try {
+        (*stacked->task)();
+    } catch (...) {
+        stacked->error = std::current_exception();
+    }
+    return nullptr;
+}
+#endif
+
+/**
+ * @brief Run task on a dedicated native stack of at least stack_size bytes
+ *
+ * The stack is reserved with MAP_NORESERVE, so pages are only committed as
+ * deep recursion touches them. Exceptions thrown by task are rethrown on
+ * the calling thread. Falls back to the current stack where unsupported.
+ */
+void runOnInterpreterStack(size_t stack_size, const std::function<void()>& task) {
+#ifdef CAESAR_HAS_INTERPRETER_STACK
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    stack_size = (stack_size + page - 1) / page * page;
+    
+    // One extra page below the stack stays inaccessible as a guard
+    size_t mapping_size = stack_size + page;
+    void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        task();
+        return;
+    }
+    mprotect(mapping, page, PROT_NONE);
+    
+    StackedTask stacked{&task, nullptr};
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstack(&attributes, static_cast<char*>(mapping) + page, stack_size);
+    
+    pthread_t thread;
+    bool started = pthread_create(&thread, &attributes, runStackedTask, &stacked) == 0;
+    pthread_attr_destroy(&attributes);
+    if (started) {
+        pthread_join(thread, nullptr);
+    }
+    munmap(mapping, mapping_size);
+    
+    if (!started) {
+        task();
+    } else if (stacked.error) {
+        std::rethrow_exception(stacked.error);
+    }
+#else
+    (void)stack_size;
+    task();
+#endif
+}
+
+bool toDouble(const Value& value, double& out) {
+    if (const double* d = std::get_if<double>(&value)) {
+        out = *d;
+        return true;
+    }
+    if (const int64_t* i = std::get_if<int64_t>(&value)) {
+        out = static_cast<double>(*i);
+        return true;
+    }
+    return false;
+}
+
+bool intBinary(TokenType op, int64_t l, int64_t r, Value& result) {
+    switch (op) {
+        case TokenType::PLUS: result = l + r; return true;
+        case TokenType::MINUS: result = l - r; return true;
+        case TokenType::MULTIPLY: result = l * r; return true;
+        case TokenType::DIVIDE:
+            if (r == 0) throw RuntimeError("Division by zero");
+            result = static_cast<double>(l) / static_cast<double>(r);
+            return true;
+        case TokenType::MODULO:
+            if (r == 0) throw RuntimeError("Modulo by zero");
+            result = l % r;
+            return true;
+        case TokenType::EQUAL: result = l == r; return true;
+        case TokenType::NOT_EQUAL: result = l != r; return true;
+        case TokenType::LESS: result = l < r; return true;
+        case TokenType::LESS_EQUAL: result = l <= r; return true;
+        case TokenType::GREATER: result = l > r; return true;
+        case TokenType::GREATER_EQUAL: result = l >= r; return true;
+        default: return false;
+    }
+}
+
+bool floatBinary(TokenType op, double l, double r, Value& result) {
+    switch (op) {
+        case TokenType::PLUS: result = l + r; return true;
+        case TokenType::MINUS: result = l - r; return true;
+        case TokenType::MULTIPLY: result = l * r; return true;
+        case TokenType::DIVIDE:
+            if (r == 0.0) throw RuntimeError("Division by zero");
+            result = l / r;
+            return true;
+        case TokenType::EQUAL: result = l == r; return true;
+        case TokenType::NOT_EQUAL: result = l != r; return true;
+        case TokenType::LESS: result = l < r; return true;
+        case TokenType::LESS_EQUAL: result = l <= r; return true;
+        case TokenType::GREATER: result = l > r; return true;
+        case TokenType::GREATER_EQUAL: result = l >= r; return true;
+        default: return false;
+    }
+}
+
+bool stringBinary(TokenType op, const String& l, const String& r, Value& result) {
+    switch (op) {
+        case TokenType::PLUS: result = String::concat(l, r); return true;
+        case TokenType::EQUAL: result = l == r; return true;
+        case TokenType::NOT_EQUAL: result = l != r; return true;
+        case TokenType::LESS: result = l < r; return true;
+        case TokenType::LESS_EQUAL: result = l <= r; return true;
+        case TokenType::GREATER: result = l > r; return true;
+        case TokenType::GREATER_EQUAL: result = l >= r; return true;
+        default: return false;
+    }
+}
+
+bool intOperands(const Value& left, const Value& right, int64_t& l, int64_t& r) {
+    const int64_t* li = std::get_if<int64_t>(&left);
+    const int64_t* ri = std::get_if<int64_t>(&right);
+    if (!li || !ri) return false;
+    l = *li;
+    r = *ri;
+    return true;
+}
+
+bool floatOperands(const Value& left, const Value& right, double& l, double& r) {
+    const double* ld = std::get_if<double>(&left);
+    const double* rd = std::get_if<double>(&right);
+    if (!ld || !rd) return false;
+    l = *ld;
+    r = *rd;
+    return true;
+}
+
+/**
+ * @brief The handler for a specialization and operator; NONE where the fast paths have none
+ */
+BinaryHandler chooseBinaryHandler(BinarySpecialization specialization, TokenType op) {
+    switch (specialization) {
+        case BinarySpecialization::INT_INT:
+            switch (op) {
+                case TokenType::PLUS: return BinaryHandler::INT_ADD;
+                case TokenType::MINUS: return BinaryHandler::INT_SUBTRACT;
+                case TokenType::MULTIPLY: return BinaryHandler::INT_MULTIPLY;
+                case TokenType::DIVIDE: return BinaryHandler::INT_DIVIDE;
+                case TokenType::MODULO: return BinaryHandler::INT_MODULO;
+                case TokenType::EQUAL: return BinaryHandler::INT_EQUAL;
+                case TokenType::NOT_EQUAL: return BinaryHandler::INT_NOT_EQUAL;
+                case TokenType::LESS: return BinaryHandler::INT_LESS;
+                case TokenType::LESS_EQUAL: return BinaryHandler::INT_LESS_EQUAL;
+                case TokenType::GREATER: return BinaryHandler::INT_GREATER;
+                case TokenType::GREATER_EQUAL: return BinaryHandler::INT_GREATER_EQUAL;
+                default: return BinaryHandler::NONE;
+            }
+        case BinarySpecialization::FLOAT_FLOAT:
+            switch (op) {
+                case TokenType::PLUS: return BinaryHandler::FLOAT_ADD;
+                case TokenType::MINUS: return BinaryHandler::FLOAT_SUBTRACT;
+                case TokenType::MULTIPLY: return BinaryHandler::FLOAT_MULTIPLY;
+                case TokenType::DIVIDE: return BinaryHandler::FLOAT_DIVIDE;
+                case TokenType::EQUAL: return BinaryHandler::FLOAT_EQUAL;
+                case TokenType::NOT_EQUAL: return BinaryHandler::FLOAT_NOT_EQUAL;
+                case TokenType::LESS: return BinaryHandler::FLOAT_LESS;
+                case TokenType::LESS_EQUAL: return BinaryHandler::FLOAT_LESS_EQUAL;
+                case TokenType::GREATER: return BinaryHandler::FLOAT_GREATER;
+                case TokenType::GREATER_EQUAL: return BinaryHandler::FLOAT_GREATER_EQUAL;
+                default: return BinaryHandler::NONE;
+            }
+        case BinarySpecialization::NUMERIC: return BinaryHandler::NUMERIC;
+        case BinarySpecialization::STRING_STRING: return BinaryHandler::STRING;
+        case BinarySpecialization::GENERIC: return BinaryHandler::GENERIC;
+        default: return BinaryHandler::NONE;
+    }
+}
+
+} // anonymous namespace
+
 // Environment implementation
-void Environment::define(const std::string& name, const Value& value) {
-    variables[name] = value;
+Value* Environment::lookup(const String& name) {
+    if (!index.empty()) {
+        auto it = index.find(name);
+        return it == index.end() ? nullptr : &variables[it->second].second;
+    }
+    
+    // Small scopes: interned names mostly compare by pointer
+    for (auto& variable : variables) {
+        if (variable.first == name) return &variable.second;
+    }
+    return nullptr;
+}
+
+void Environment::define(const String& name, const Value& value) {
+    GcHeap::writeBarrier(value);
+    if (Value* existing = lookup(name)) {
+        *existing = value;
+        return;
+    }
+    
+    // Keys are interned so lookups by interned names compare pointers
+    variables.emplace_back(name.isInterned() ? name : String::intern(name.view()), value);
+    
+    if (variables.size() > INDEX_THRESHOLD) {
+        if (index.empty()) {
+            for (size_t i = 0; i < variables.size(); i++) {
+                index.emplace(variables[i].first, i);
+            }
+        } else {
+            index.emplace(variables.back().first, variables.size() - 1);
+        }
+    }
 }
 
-Value Environment::get(const std::string& name) {
-    auto it = variables.find(name);
-    if (it != variables.end()) {
-        return it->second;
+Value Environment::get(const String& name) {
+    if (Value* value = lookup(name)) {
+        return *value;
     }
     
     if (parent) {
         return parent->get(name);
     }
     
-    throw RuntimeError("Undefined variable '" + name + "'");
+    throw RuntimeError("Undefined variable '" + name.str() + "'");
 }
 
-void Environment::assign(const std::string& name, const Value& value) {
-    auto it = variables.find(name);
-    if (it != variables.end()) {
-        it->second = value;
+void Environment::assign(const String& name, const Value& value) {
+    if (Value* existing = lookup(name)) {
+        GcHeap::writeBarrier(value);
+        *existing = value;
         return;
     }
     
@@ -42,76 +291,174 @@ void Environment::assign(const std::string& name, const Value& value) {
         return;
     }
     
-    throw RuntimeError("Undefined variable '" + name + "'");
+    throw RuntimeError("Undefined variable '" + name.str() + "'");
+}
+
+bool Environment::exists(const String& name) {
+    return lookup(name) != nullptr || (parent && parent->exists(name));
 }
 
-bool Environment::exists(const std::string& name) {
-    return variables.find(name) != variables.end() || 
-           (parent && parent->exists(name));
+void Environment::traverse(GcVisitor& visitor) const {
+    if (parent) visitor.visit(parent.get());
+    for (const auto& variable : variables) {
+        visitor.visitValue(variable.second);
+    }
+}
+
+void Environment::clearReferences() {
+    parent.reset();
+    variables.clear();
+    index.clear();
 }
 
 // CallableFunction implementation
-Value CallableFunction::call(Interpreter& interpreter, const std::vector<Value>& arguments) {
-    // Create new environment for function execution
-    auto function_env = std::make_shared<Environment>(closure);
+void CallableFunction::bindArguments(Interpreter& interpreter, ArgumentList& arguments, size_t register_base) const {
+    auto& params = declaration->parameters;
+    auto& registers = interpreter.registers;
+    
+    // Check for too many arguments
+    if (arguments.size() > params.size()) {
+        throw RuntimeError("Too many arguments: expected " + std::to_string(params.size()) + 
+                          ", got " + std::to_string(arguments.size()));
+    }
+    
+    // Release the locals of a previous tail call in this frame
+    registers.resize(register_base);
+    interpreter.register_base = register_base;
+    
+    // Captured locals get a cell per call, shared with the closures created by it
+    registers.resize(register_base + declaration->slot_names.size());
+    for (uint32_t slot : declaration->cell_slots) {
+        registers[register_base + slot].cell = makeRef<Cell>();
+    }
     
     // Bind parameters to arguments
-    auto& params = declaration->parameters;
     for (size_t i = 0; i < params.size(); i++) {
         Value arg_value = nullptr;
         
         if (i < arguments.size()) {
-            // Use provided argument
-            arg_value = arguments[i];
+            // Use provided argument; the list dies with the call, so take the value
+            arg_value = std::move(arguments[i]);
         } else if (params[i].default_value) {
-            // Use default value
-            auto previous_env = interpreter.getCurrentEnvironment();
-            // Set environment temporarily to evaluate default value in closure context
-            interpreter.environment = closure;
+            // Evaluate default value in closure context; may run calls that grow registers
+            interpreter.environment = closure.get();
             arg_value = interpreter.evaluate(params[i].default_value.get());
-            interpreter.environment = previous_env;
         } else {
             throw RuntimeError("Missing argument for parameter '" + params[i].name + "'");
         }
         
-        function_env->define(params[i].name, arg_value);
+        // Parameters occupy the first registers, in order
+        Register& slot = registers[register_base + i];
+        if (slot.cell) {
+            GcHeap::writeBarrier(arg_value);
+            slot.cell->value = std::move(arg_value);
+            slot.cell->bound = true;
+        } else {
+            slot.value = std::move(arg_value);
+            slot.bound = true;
+        }
     }
     
-    // Check for too many arguments
-    if (arguments.size() > params.size()) {
-        throw RuntimeError("Too many arguments: expected " + std::to_string(params.size()) + 
-                          ", got " + std::to_string(arguments.size()));
+    interpreter.environment = closure.get();
+}
+
+Value CallableFunction::call(Interpreter& interpreter, ArgumentList&& arguments) {
+    auto& frames = interpreter.frames;
+    if (frames.size() >= interpreter.max_recursion) {
+        throw RuntimeError("maximum recursion depth exceeded (limit " +
+                           std::to_string(interpreter.max_recursion) + ")");
     }
+    size_t register_base = interpreter.registers.size();
+    frames.push_back(CallFrame{this, interpreter.environment, nullptr, nullptr, {}, register_base,
+                               interpreter.current_statement});
     
-    // Execute function body in new environment
-    auto previous_env = interpreter.getCurrentEnvironment();
-    interpreter.environment = function_env;
+    // Tail calls swap these out and loop instead of recursing
+    Ref<CallableFunction> tail_function;
+    ArgumentList tail_arguments;
+    const CallableFunction* function = this;
+    ArgumentList* args = &arguments;
     
     try {
-        declaration->body->accept(interpreter);
-        // Function completed without explicit return
-        interpreter.environment = previous_env;
-        return nullptr;
-    } catch (const ReturnException& ret) {
-        interpreter.environment = previous_env;
-        return ret.value;
+        while (true) {
+            function->bindArguments(interpreter, *args, register_base);
+            function->declaration->body->accept(interpreter);
+            interpreter.returning = false;
+            
+            // Inner calls have popped their frames, so ours is on top again
+            CallFrame& frame = frames.back();
+            if (!frame.tail_function) break;
+            
+            // The tail call replaces this one; callObserved() ends whichever runs last
+            if (interpreter.observing_calls) interpreter.endObservedCall(TraceCategory::FUNCTION);
+            
+            // Drop this call's environment before running the callee
+            interpreter.environment = frame.caller_environment;
+            tail_function = std::move(frame.tail_function);
+            tail_arguments = std::move(frame.tail_arguments);
+            frame.tail_function = nullptr;
+            frame.tail_arguments.clear();
+            function = tail_function.get();
+            args = &tail_arguments;
+            frame.function = function;
+            if (interpreter.observing_calls) {
+                interpreter.beginObservedCall(function->declaration, function->declaration->name,
+                                              TraceCategory::FUNCTION);
+            }
+        }
     } catch (...) {
-        interpreter.environment = previous_env;
+        interpreter.environment = frames.back().caller_environment;
+        interpreter.current_statement = frames.back().caller_statement;
+        interpreter.returning = false;
+        interpreter.registers.resize(register_base);
+        frames.pop_back();
+        interpreter.register_base = frames.empty() ? 0 : frames.back().register_base;
         throw;
     }
+    
+    interpreter.pollProfiler();
+    CallFrame& frame = frames.back();
+    interpreter.environment = frame.caller_environment;
+    interpreter.current_statement = frame.caller_statement;
+    Value result = std::move(frame.return_value);
+    interpreter.registers.resize(register_base);
+    frames.pop_back();
+    interpreter.register_base = frames.empty() ? 0 : frames.back().register_base;
+    return result;
+}
+
+void CallableFunction::traverse(GcVisitor& visitor) const {
+    if (closure) visitor.visit(closure.get());
+    for (const auto& cell : upvalues) {
+        visitor.visit(cell.get());
+    }
+}
+
+void CallableFunction::clearReferences() {
+    closure.reset();
+    upvalues.clear();
 }
 
 // Interpreter implementation
-Interpreter::Interpreter() {
-    environment = std::make_shared<Environment>();
+Interpreter::Interpreter() : max_recursion(DEFAULT_MAX_RECURSION) {
+    globals = makeRef<Environment>();
+    environment = globals.get();
     initializeBuiltins();
 }
 
+Interpreter::~Interpreter() {
+    // Functions defined at top level and the globals refer to each other
+    environment = nullptr;
+    globals.reset();
+    last_value = nullptr;
+    GcHeap::instance().collect();
+}
+
 Value Interpreter::interpret(Program* program) {
     Value result = nullptr;
     
     try {
-        program->accept(*this);
+        runOnInterpreterStack(NATIVE_STACK_BASE + max_recursion * NATIVE_STACK_PER_CALL,
+                              [this, program] { program->accept(*this); });
         result = last_value;
     } catch (const RuntimeError& e) {
         std::cerr << "Runtime Error: " << e.what() << std::endl;
@@ -121,110 +468,225 @@ Value Interpreter::interpret(Program* program) {
     return result;
 }
 
-std::shared_ptr<Environment> Interpreter::getCurrentEnvironment() const {
-    return environment;
+Ref<Environment> Interpreter::getCurrentEnvironment() const {
+    return Ref<Environment>(environment);
 }
 
 Value Interpreter::evaluate(Expression* expr) {
     expr->accept(*this);
-    return last_value;
+    return std::exchange(last_value, nullptr);
 }
 
 // Expression visitors
 void Interpreter::visit(LiteralExpression& node) {
-    last_value = tokenToValue(node.value);
+    switch (node.value.type) {
+        case TokenType::INTEGER:
+        case TokenType::FLOAT:
+            last_value = tokenToValue(node.value);
+            break;
+        default:
+            last_value = node.interned_value;
+            break;
+    }
 }
 
 void Interpreter::visit(IdentifierExpression& node) {
-    // Check if it's a builtin function reference
-    auto builtin_it = builtins.find(node.name);
-    if (builtin_it != builtins.end()) {
-        last_value = std::string("__builtin_" + node.name);
+    // Builtins take precedence over variables in every scope. They never
+    // change, so each node looks its name up once.
+    if (!node.builtin_checked) {
+        node.builtin_checked = true;
+        if (builtins.count(node.symbol)) {
+            node.builtin_reference = String::intern("__builtin_" + node.name);
+        }
+    }
+    if (!node.builtin_reference.empty()) {
+        last_value = node.builtin_reference;
         return;
     }
     
-    last_value = environment->get(node.name);
-}
-
-void Interpreter::visit(BinaryExpression& node) {
-    Value left = evaluate(node.left.get());
-    Value right = evaluate(node.right.get());
-    
-    // Handle arithmetic operations
-    if (std::holds_alternative<int64_t>(left) && std::holds_alternative<int64_t>(right)) {
-        int64_t l = std::get<int64_t>(left);
-        int64_t r = std::get<int64_t>(right);
-        
-        switch (node.operator_type) {
-            case TokenType::PLUS: last_value = l + r; return;
-            case TokenType::MINUS: last_value = l - r; return;
-            case TokenType::MULTIPLY: last_value = l * r; return;
-            case TokenType::DIVIDE: 
-                if (r == 0) throw RuntimeError("Division by zero");
-                last_value = static_cast<double>(l) / static_cast<double>(r); 
+    // Locals and captures of the running function; unbound ones fall back to the
+    // same name in the enclosing functions, then to globals
+    switch (node.kind) {
+        case VariableKind::LOCAL: {
+            const Register& slot = registers[register_base + static_cast<size_t>(node.slot)];
+            if (slot.bound) {
+                last_value = slot.value;
                 return;
-            case TokenType::MODULO: 
-                if (r == 0) throw RuntimeError("Modulo by zero");
-                last_value = l % r; 
+            }
+            break;
+        }
+        case VariableKind::CELL: {
+            const Cell& cell = *registers[register_base + static_cast<size_t>(node.slot)].cell;
+            if (cell.bound) {
+                last_value = cell.value;
                 return;
-            case TokenType::EQUAL: last_value = l == r; return;
-            case TokenType::NOT_EQUAL: last_value = l != r; return;
-            case TokenType::LESS: last_value = l < r; return;
-            case TokenType::LESS_EQUAL: last_value = l <= r; return;
-            case TokenType::GREATER: last_value = l > r; return;
-            case TokenType::GREATER_EQUAL: last_value = l >= r; return;
-            default: break;
+            }
+            break;
         }
-    }
-    
-    // Handle floating-point operations
-    if ((std::holds_alternative<double>(left) || std::holds_alternative<int64_t>(left)) &&
-        (std::holds_alternative<double>(right) || std::holds_alternative<int64_t>(right))) {
-        
-        double l = std::holds_alternative<double>(left) ? std::get<double>(left) : static_cast<double>(std::get<int64_t>(left));
-        double r = std::holds_alternative<double>(right) ? std::get<double>(right) : static_cast<double>(std::get<int64_t>(right));
-        
-        switch (node.operator_type) {
-            case TokenType::PLUS: last_value = l + r; return;
-            case TokenType::MINUS: last_value = l - r; return;
-            case TokenType::MULTIPLY: last_value = l * r; return;
-            case TokenType::DIVIDE: 
-                if (r == 0.0) throw RuntimeError("Division by zero");
-                last_value = l / r; 
+        case VariableKind::UPVALUE: {
+            const Cell& cell = *frames.back().function->getUpvalue(static_cast<size_t>(node.slot));
+            if (cell.bound) {
+                last_value = cell.value;
                 return;
-            case TokenType::EQUAL: last_value = l == r; return;
-            case TokenType::NOT_EQUAL: last_value = l != r; return;
-            case TokenType::LESS: last_value = l < r; return;
-            case TokenType::LESS_EQUAL: last_value = l <= r; return;
-            case TokenType::GREATER: last_value = l > r; return;
-            case TokenType::GREATER_EQUAL: last_value = l >= r; return;
-            default: break;
+            }
+            break;
         }
+        case VariableKind::NAME:
+            break;
     }
-    
-    // Handle string concatenation and comparison
-    if (std::holds_alternative<std::string>(left) && std::holds_alternative<std::string>(right)) {
-        std::string l = std::get<std::string>(left);
-        std::string r = std::get<std::string>(right);
-        
-        switch (node.operator_type) {
-            case TokenType::PLUS: last_value = l + r; return;
-            case TokenType::EQUAL: last_value = l == r; return;
-            case TokenType::NOT_EQUAL: last_value = l != r; return;
-            case TokenType::LESS: last_value = l < r; return;
-            case TokenType::LESS_EQUAL: last_value = l <= r; return;
-            case TokenType::GREATER: last_value = l > r; return;
-            case TokenType::GREATER_EQUAL: last_value = l >= r; return;
-            default: break;
+    for (int32_t upvalue : node.fallbacks) {
+        const Cell& cell = *frames.back().function->getUpvalue(static_cast<size_t>(upvalue));
+        if (cell.bound) {
+            last_value = cell.value;
+            return;
         }
     }
     
+    last_value = environment->get(node.symbol);
+}
+
+void Interpreter::visit(BinaryExpression& node) {
+    node.left->accept(*this);
+    Value left = std::move(last_value);
+    node.right->accept(*this);
+    Value right = std::move(last_value);
+    if (execution_stats) execution_stats->countBinaryOperands(node.operator_type, left, right);
+    
+    // Fast path: one jump to the handler for this node's operand types and operator
+    int64_t li, ri;
+    double ld, rd;
+#ifdef CAESAR_COMPUTED_GOTO
+    static void* const handlers[] = {
+#define CAESAR_BINARY_HANDLER_LABEL(name) &&handle_##name,
+        CAESAR_BINARY_HANDLERS(CAESAR_BINARY_HANDLER_LABEL)
+#undef CAESAR_BINARY_HANDLER_LABEL
+    };
+#define CAESAR_HANDLE(name) handle_##name
+    goto *handlers[static_cast<uint8_t>(node.handler)];
+#else
+#define CAESAR_HANDLE(name) case BinaryHandler::name
+    switch (node.handler) {
+#endif
+
+// Each handler returns, or jumps to respecialize when its guard fails
+#define CAESAR_INT_HANDLER(name, expression) \
+    CAESAR_HANDLE(name): \
+        if (!intOperands(left, right, li, ri)) goto respecialize; \
+        last_value = expression; \
+        return;
+#define CAESAR_FLOAT_HANDLER(name, expression) \
+    CAESAR_HANDLE(name): \
+        if (!floatOperands(left, right, ld, rd)) goto respecialize; \
+        last_value = expression; \
+        return;
+
+    CAESAR_INT_HANDLER(INT_ADD, li + ri)
+    CAESAR_INT_HANDLER(INT_SUBTRACT, li - ri)
+    CAESAR_INT_HANDLER(INT_MULTIPLY, li * ri)
+    CAESAR_INT_HANDLER(INT_EQUAL, li == ri)
+    CAESAR_INT_HANDLER(INT_NOT_EQUAL, li != ri)
+    CAESAR_INT_HANDLER(INT_LESS, li < ri)
+    CAESAR_INT_HANDLER(INT_LESS_EQUAL, li <= ri)
+    CAESAR_INT_HANDLER(INT_GREATER, li > ri)
+    CAESAR_INT_HANDLER(INT_GREATER_EQUAL, li >= ri)
+    CAESAR_FLOAT_HANDLER(FLOAT_ADD, ld + rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_SUBTRACT, ld - rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_MULTIPLY, ld * rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_EQUAL, ld == rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_NOT_EQUAL, ld != rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_LESS, ld < rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_LESS_EQUAL, ld <= rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_GREATER, ld > rd)
+    CAESAR_FLOAT_HANDLER(FLOAT_GREATER_EQUAL, ld >= rd)
+#undef CAESAR_INT_HANDLER
+#undef CAESAR_FLOAT_HANDLER
+
+    CAESAR_HANDLE(INT_DIVIDE):
+        if (!intOperands(left, right, li, ri)) goto respecialize;
+        if (ri == 0) throw RuntimeError("Division by zero");
+        last_value = static_cast<double>(li) / static_cast<double>(ri);
+        return;
+    CAESAR_HANDLE(INT_MODULO):
+        if (!intOperands(left, right, li, ri)) goto respecialize;
+        if (ri == 0) throw RuntimeError("Modulo by zero");
+        last_value = li % ri;
+        return;
+    CAESAR_HANDLE(FLOAT_DIVIDE):
+        if (!floatOperands(left, right, ld, rd)) goto respecialize;
+        if (rd == 0.0) throw RuntimeError("Division by zero");
+        last_value = ld / rd;
+        return;
+    CAESAR_HANDLE(NUMERIC):
+        if ((std::holds_alternative<double>(left) || std::holds_alternative<double>(right)) &&
+            toDouble(left, ld) && toDouble(right, rd) &&
+            floatBinary(node.operator_type, ld, rd, last_value)) return;
+        goto respecialize;
+    CAESAR_HANDLE(STRING): {
+        const String* ls = std::get_if<String>(&left);
+        const String* rs = std::get_if<String>(&right);
+        if (ls && rs && stringBinary(node.operator_type, *ls, *rs, last_value)) return;
+        goto respecialize;
+    }
+    CAESAR_HANDLE(GENERIC):
+        evaluateBinaryGeneric(node.operator_type, left, right);
+        return;
+    CAESAR_HANDLE(NONE):
+        goto respecialize;
+#ifndef CAESAR_COMPUTED_GOTO
+    }
+#endif
+#undef CAESAR_HANDLE
+
+respecialize:
+    // First evaluation or failed guard: re-specialize and take the generic path
+    BinarySpecialization previous = node.specialization;
+    specializeBinary(node, left, right);
+    if (execution_stats) execution_stats->countSpecialization(previous, node.specialization);
+    evaluateBinaryGeneric(node.operator_type, left, right);
+}
+
+void Interpreter::specializeBinary(BinaryExpression& node, const Value& left, const Value& right) {
+    if (node.specialization != BinarySpecialization::UNSPECIALIZED &&
+        ++node.deopt_count >= MAX_BINARY_DEOPTS) {
+        node.specialization = BinarySpecialization::GENERIC;
+    } else if (node.operator_type == TokenType::AND || node.operator_type == TokenType::OR) {
+        node.specialization = BinarySpecialization::GENERIC;
+    } else if (std::holds_alternative<int64_t>(left) && std::holds_alternative<int64_t>(right)) {
+        node.specialization = BinarySpecialization::INT_INT;
+    } else if (std::holds_alternative<double>(left) && std::holds_alternative<double>(right)) {
+        node.specialization = BinarySpecialization::FLOAT_FLOAT;
+    } else if ((std::holds_alternative<double>(left) || std::holds_alternative<int64_t>(left)) &&
+               (std::holds_alternative<double>(right) || std::holds_alternative<int64_t>(right))) {
+        node.specialization = BinarySpecialization::NUMERIC;
+    } else if (std::holds_alternative<String>(left) && std::holds_alternative<String>(right)) {
+        node.specialization = BinarySpecialization::STRING_STRING;
+    } else {
+        node.specialization = BinarySpecialization::GENERIC;
+    }
+    node.handler = chooseBinaryHandler(node.specialization, node.operator_type);
+}
+
+void Interpreter::evaluateBinaryGeneric(TokenType op, const Value& left, const Value& right) {
+    // Handle integer arithmetic
+    const int64_t* li = std::get_if<int64_t>(&left);
+    const int64_t* ri = std::get_if<int64_t>(&right);
+    if (li && ri && intBinary(op, *li, *ri, last_value)) return;
+    
+    // Handle floating-point operations
+    double ld, rd;
+    if (toDouble(left, ld) && toDouble(right, rd) && floatBinary(op, ld, rd, last_value)) return;
+    
+    // Handle string concatenation and comparison
+    const String* ls = std::get_if<String>(&left);
+    const String* rs = std::get_if<String>(&right);
+    if (ls && rs && stringBinary(op, *ls, *rs, last_value)) return;
+    
     // Handle logical operations
-    if (node.operator_type == TokenType::AND) {
+    if (op == TokenType::AND) {
         last_value = isTruthy(left) && isTruthy(right);
         return;
     }
-    if (node.operator_type == TokenType::OR) {
+    if (op == TokenType::OR) {
         last_value = isTruthy(left) || isTruthy(right);
         return;
     }
@@ -243,46 +705,163 @@ void Interpreter::visit(UnaryExpression& node) {
 }
 
 void Interpreter::visit(CallExpression& node) {
+    // Method call on a runtime object, e.g. items.append(x)
+    if (auto member = dynamic_cast<MemberExpression*>(node.function.get())) {
+        Value object = evaluate(member->object.get());
+        
+        ArgumentList arguments;
+        for (auto& arg : node.arguments) {
+            arguments.push_back(evaluate(arg.get()));
+        }
+        
+        last_value = callMethod(object, member->member, arguments);
+        return;
+    }
+    
     Value callee = evaluate(node.function.get());
     
-    std::vector<Value> arguments;
+    ArgumentList arguments;
     for (auto& arg : node.arguments) {
         arguments.push_back(evaluate(arg.get()));
     }
     
+    last_value = callValue(callee, std::move(arguments));
+}
+
+Value Interpreter::callValue(const Value& callee, ArgumentList&& arguments) {
+    if (observing_calls) return callObserved(callee, std::move(arguments));
+    
     // Check if it's a user-defined function
-    if (std::holds_alternative<std::shared_ptr<CallableFunction>>(callee)) {
-        auto function = std::get<std::shared_ptr<CallableFunction>>(callee);
-        last_value = function->call(*this, arguments);
-        return;
+    if (auto function = std::get_if<Ref<CallableFunction>>(&callee)) {
+        // The caller's callee value keeps the function alive even if the call reassigns its name
+        return (*function)->call(*this, std::move(arguments));
     }
     
     // Check if it's a builtin function
-    if (std::holds_alternative<std::string>(callee)) {
-        std::string builtin_name = std::get<std::string>(callee);
-        if (builtin_name.substr(0, 10) == "__builtin_") {
-            std::string func_name = builtin_name.substr(10);
-            auto it = builtins.find(func_name);
-            if (it != builtins.end()) {
-                last_value = it->second(arguments);
-                return;
-            }
+    if (const BuiltinReference* builtin = findBuiltin(callee)) {
+        return (*builtin->function)(arguments);
+    }
+    
+    throw RuntimeError("Object is not callable");
+}
+
+Value Interpreter::callObserved(const Value& callee, ArgumentList&& arguments) {
+    if (auto function = std::get_if<Ref<CallableFunction>>(&callee)) {
+        const FunctionDefinition* declaration = (*function)->getDeclaration();
+        beginObservedCall(declaration, declaration->name, TraceCategory::FUNCTION);
+        Value result;
+        try {
+            result = (*function)->call(*this, std::move(arguments));
+        } catch (...) {
+            endObservedCall(TraceCategory::FUNCTION);
+            throw;
+        }
+        endObservedCall(TraceCategory::FUNCTION);
+        return result;
+    }
+    
+    if (const BuiltinReference* builtin = findBuiltin(callee)) {
+        // The name is interned, so it outlives the tracer, which keeps it until exit
+        beginObservedCall(builtin->function, builtin->name.view(), TraceCategory::BUILTIN);
+        Value result;
+        try {
+            result = (*builtin->function)(arguments);
+        } catch (...) {
+            endObservedCall(TraceCategory::BUILTIN);
+            throw;
         }
+        endObservedCall(TraceCategory::BUILTIN);
+        return result;
     }
     
     throw RuntimeError("Object is not callable");
 }
 
+void Interpreter::beginObservedCall(const void* key, std::string_view name, TraceCategory category) {
+    if (function_profiler) function_profiler->enter(key, name);
+    if (tracer) tracer->begin(name, category);
+}
+
+void Interpreter::endObservedCall(TraceCategory category) {
+    if (tracer) tracer->end(category);
+    if (function_profiler) function_profiler->exit();
+}
+
+const Interpreter::BuiltinReference* Interpreter::findBuiltin(const Value& callee) const {
+    if (!std::holds_alternative<String>(callee)) return nullptr;
+    
+    // Builtins are referenced as "__builtin_<name>" strings
+    auto it = builtin_references.find(std::get<String>(callee));
+    return it != builtin_references.end() ? &it->second : nullptr;
+}
+
 void Interpreter::visit(MemberExpression& node) {
     (void)node;
     last_value = nullptr;
 }
 
+void Interpreter::visit(IndexExpression& node) {
+    Value object = evaluate(node.object.get());
+    Value index = evaluate(node.index.get());
+    
+    if (auto dict = std::get_if<Ref<DictObject>>(&object)) {
+        const Value* value = (*dict)->find(index);
+        if (!value) {
+            throw RuntimeError("KeyError: " + valueToString(index));
+        }
+        last_value = *value;
+        return;
+    }
+    
+    const int64_t* i = std::get_if<int64_t>(&index);
+    if (!i) {
+        throw RuntimeError("indices must be integers");
+    }
+    
+    if (auto list = std::get_if<Ref<ListObject>>(&object)) {
+        last_value = (*list)->get((*list)->normalizeIndex(*i));
+        return;
+    }
+    
+    if (auto str = std::get_if<String>(&object)) {
+        int64_t length = static_cast<int64_t>(str->size());
+        int64_t position = *i < 0 ? *i + length : *i;
+        if (position < 0 || position >= length) {
+            throw RuntimeError("string index out of range");
+        }
+        last_value = String(str->view().substr(static_cast<size_t>(position), 1));
+        return;
+    }
+    
+    throw RuntimeError("object is not subscriptable");
+}
+
 void Interpreter::visit(AssignmentExpression& node) {
     Value value = evaluate(node.value.get());
     
     if (auto identifier = dynamic_cast<IdentifierExpression*>(node.target.get())) {
-        environment->define(identifier->name, value);
+        defineVariable(identifier->kind, identifier->slot, identifier->symbol, value);
+        last_value = value;
+    } else if (auto index_target = dynamic_cast<IndexExpression*>(node.target.get())) {
+        Value object = evaluate(index_target->object.get());
+        Value index = evaluate(index_target->index.get());
+        
+        if (auto dict = std::get_if<Ref<DictObject>>(&object)) {
+            (*dict)->set(index, value);
+            last_value = value;
+            return;
+        }
+        
+        auto list = std::get_if<Ref<ListObject>>(&object);
+        if (!list) {
+            throw RuntimeError("object does not support item assignment");
+        }
+        const int64_t* i = std::get_if<int64_t>(&index);
+        if (!i) {
+            throw RuntimeError("list indices must be integers");
+        }
+        
+        (*list)->set((*list)->normalizeIndex(*i), value);
         last_value = value;
     } else {
         throw RuntimeError("Invalid assignment target");
@@ -290,23 +869,105 @@ void Interpreter::visit(AssignmentExpression& node) {
 }
 
 void Interpreter::visit(ListExpression& node) {
-    (void)node;
-    last_value = std::string("[list]");
+    auto list = makeRef<ListObject>();
+    for (auto& element : node.elements) {
+        list->append(evaluate(element.get()));
+    }
+    last_value = list;
 }
 
 void Interpreter::visit(DictExpression& node) {
-    (void)node;
-    last_value = std::string("[dict]");
+    auto dict = makeRef<DictObject>();
+    dict->reserve(node.pairs.size());
+    for (auto& pair : node.pairs) {
+        Value key = evaluate(pair.first.get());
+        dict->set(key, evaluate(pair.second.get()));
+    }
+    last_value = dict;
+}
+
+Value Interpreter::callMethod(const Value& object, const std::string& name, const ArgumentList& arguments) {
+    if (auto list = std::get_if<Ref<ListObject>>(&object)) {
+        ListObject& items = **list;
+        
+        if (name == "append") {
+            if (arguments.size() != 1) {
+                throw RuntimeError("append() takes exactly one argument");
+            }
+            items.append(arguments[0]);
+            return nullptr;
+        }
+        
+        if (name == "pop") {
+            if (arguments.size() > 1) {
+                throw RuntimeError("pop() takes at most one argument");
+            }
+            if (items.empty()) {
+                throw RuntimeError("pop from empty list");
+            }
+            int64_t index = -1;
+            if (!arguments.empty()) {
+                if (!std::holds_alternative<int64_t>(arguments[0])) {
+                    throw RuntimeError("list indices must be integers");
+                }
+                index = std::get<int64_t>(arguments[0]);
+            }
+            return items.pop(items.normalizeIndex(index));
+        }
+    }
+    
+    if (auto dict = std::get_if<Ref<DictObject>>(&object)) {
+        DictObject& map = **dict;
+        
+        if (name == "get") {
+            if (arguments.empty() || arguments.size() > 2) {
+                throw RuntimeError("get() takes one or two arguments");
+            }
+            const Value* value = map.find(arguments[0]);
+            if (value) return *value;
+            return arguments.size() == 2 ? arguments[1] : Value(nullptr);
+        }
+        
+        if (name == "pop") {
+            if (arguments.empty() || arguments.size() > 2) {
+                throw RuntimeError("pop() takes one or two arguments");
+            }
+            Value removed;
+            if (map.remove(arguments[0], &removed)) return removed;
+            if (arguments.size() == 2) return arguments[1];
+            throw RuntimeError("KeyError: " + valueToString(arguments[0]));
+        }
+        
+        if (name == "keys" || name == "values") {
+            if (!arguments.empty()) {
+                throw RuntimeError(name + "() takes no arguments");
+            }
+            bool keys = name == "keys";
+            auto result = makeRef<ListObject>();
+            for (const auto& entry : map.entries()) {
+                if (entry.live) result->append(keys ? entry.key : entry.value);
+            }
+            return result;
+        }
+    }
+    
+    throw RuntimeError("object has no attribute '" + name + "'");
 }
 
 // Statement visitors
 void Interpreter::visit(ExpressionStatement& node) {
-    evaluate(node.expression.get());
+    // Leave the value in last_value: it is the program's result if this statement is last
+    node.expression->accept(*this);
 }
 
 void Interpreter::visit(BlockStatement& node) {
+    GcHeap& heap = GcHeap::instance();
     for (auto& stmt : node.statements) {
+        current_statement = stmt.get();
         stmt->accept(*this);
+        if (returning) return;
+        heap.maybeCollect();
+        pollProfiler();
     }
 }
 
@@ -321,31 +982,73 @@ void Interpreter::visit(IfStatement& node) {
 }
 
 void Interpreter::visit(WhileStatement& node) {
-    try {
-        while (isTruthy(evaluate(node.condition.get()))) {
+    Tracer::LoopScope loop_trace(tracer, "while", node.position.line);
+    while (isTruthy(evaluate(node.condition.get()))) {
+        try {
+            node.body->accept(*this);
+        } catch (const ContinueException&) {
+            // Continue to next iteration
+            continue;
+        } catch (const BreakException&) {
+            // Break out of loop
+            break;
+        }
+        if (returning) break;
+    }
+}
+
+void Interpreter::visit(ForStatement& node) {
+    Tracer::LoopScope loop_trace(tracer, "for", node.position.line);
+    
+    // For now, implement simple for-in loop over ranges or iterables
+    Value iterable_value = evaluate(node.iterable.get());
+    
+    // Iterate over list elements; the local reference keeps the list alive
+    if (std::holds_alternative<Ref<ListObject>>(iterable_value)) {
+        auto list = std::get<Ref<ListObject>>(iterable_value);
+        
+        for (size_t i = 0; i < list->size(); i++) {
+            defineVariable(node.variable_kind, node.variable_slot, node.variable_symbol, list->get(i));
             try {
                 node.body->accept(*this);
             } catch (const ContinueException&) {
-                // Continue to next iteration
                 continue;
             } catch (const BreakException&) {
-                // Break out of loop
                 break;
             }
+            if (returning) break;
         }
-    } catch (const ReturnException&) {
-        // Propagate return up the call stack
-        throw;
+        return;
+    }
+    
+    // Iterate over dict keys in insertion order
+    if (std::holds_alternative<Ref<DictObject>>(iterable_value)) {
+        auto dict = std::get<Ref<DictObject>>(iterable_value);
+        size_t size = dict->size();
+        
+        // Entries are re-read by position: the body may insert into the dict
+        for (size_t i = 0; i < dict->entries().size(); i++) {
+            if (dict->size() != size) {
+                throw RuntimeError("dictionary changed size during iteration");
+            }
+            const DictObject::Entry& entry = dict->entries()[i];
+            if (!entry.live) continue;
+            defineVariable(node.variable_kind, node.variable_slot, node.variable_symbol, entry.key);
+            try {
+                node.body->accept(*this);
+            } catch (const ContinueException&) {
+                continue;
+            } catch (const BreakException&) {
+                break;
+            }
+            if (returning) break;
+        }
+        return;
     }
-}
-
-void Interpreter::visit(ForStatement& node) {
-    // For now, implement simple for-in loop over ranges or iterables
-    Value iterable_value = evaluate(node.iterable.get());
     
     // Handle range() function calls for for-loops
-    if (std::holds_alternative<std::string>(iterable_value)) {
-        std::string str_val = std::get<std::string>(iterable_value);
+    if (std::holds_alternative<String>(iterable_value)) {
+        std::string str_val = std::get<String>(iterable_value).str();
         if (str_val.find("__range_") == 0) {
             // Parse range parameters from string like "__range_0_10_1"
             size_t first_underscore = str_val.find('_', 8);  // After "__range_"
@@ -356,49 +1059,109 @@ void Interpreter::visit(ForStatement& node) {
                 int end = std::stoi(str_val.substr(first_underscore + 1, second_underscore - first_underscore - 1));
                 int step = std::stoi(str_val.substr(second_underscore + 1));
                 
-                try {
-                    for (int i = start; i < end; i += step) {
-                        environment->define(node.variable, static_cast<int64_t>(i));
-                        try {
-                            node.body->accept(*this);
-                        } catch (const ContinueException&) {
-                            continue;
-                        } catch (const BreakException&) {
-                            break;
-                        }
+                for (int i = start; i < end; i += step) {
+                    defineVariable(node.variable_kind, node.variable_slot, node.variable_symbol, static_cast<int64_t>(i));
+                    try {
+                        node.body->accept(*this);
+                    } catch (const ContinueException&) {
+                        continue;
+                    } catch (const BreakException&) {
+                        break;
                     }
-                } catch (const ReturnException&) {
-                    throw; // Propagate return
+                    if (returning) break;
                 }
             }
         }
     }
-    
-    // TODO: Add support for other iterables like lists
 }
 
 void Interpreter::visit(FunctionDefinition& node) {
+    // Nested definitions were already resolved along with their enclosing function
+    if (!node.resolved) {
+        Resolver::resolve(node);
+    }
+    
     // Create a callable function object with current environment as closure
-    auto function = std::make_shared<CallableFunction>(
-        std::shared_ptr<FunctionDefinition>(&node, [](FunctionDefinition*){}), // Non-owning shared_ptr
-        environment
-    );
+    auto function = makeRef<CallableFunction>(&node, Ref<Environment>(environment));
+    
+    // Capture only the cells the new function references
+    for (const UpvalueDescriptor& upvalue : node.upvalues) {
+        if (upvalue.from_parent_local) {
+            function->addUpvalue(registers[register_base + upvalue.index].cell);
+        } else {
+            function->addUpvalue(frames.back().function->getUpvalue(upvalue.index));
+        }
+    }
     
-    // Define the function in current environment
-    environment->define(node.name, function);
+    // Define the function in current scope
+    defineVariable(node.name_kind, node.name_slot, String::intern(node.name), function);
+}
+
+void Interpreter::defineVariable(VariableKind kind, int32_t slot, const String& name, const Value& value) {
+    switch (kind) {
+        case VariableKind::LOCAL: {
+            Register& local = registers[register_base + static_cast<size_t>(slot)];
+            local.value = value;
+            local.bound = true;
+            break;
+        }
+        case VariableKind::CELL: {
+            Cell& cell = *registers[register_base + static_cast<size_t>(slot)].cell;
+            GcHeap::writeBarrier(value);
+            cell.value = value;
+            cell.bound = true;
+            break;
+        }
+        default:
+            // Assigning a name makes it local, so upvalues are never assigned
+            environment->define(name, value);
+            break;
+    }
 }
 
 void Interpreter::visit(ClassDefinition& node) {
-    (void)node;
-    environment->define(node.name, std::string("__class_" + node.name));
+    defineVariable(node.name_kind, node.name_slot, String::intern(node.name), String("__class_" + node.name));
 }
 
 void Interpreter::visit(ReturnStatement& node) {
+    // Outside any function there is no frame to return to
+    if (frames.empty()) {
+        Value return_value = nullptr;
+        if (node.value) {
+            return_value = evaluate(node.value.get());
+        }
+        throw ReturnException(return_value);
+    }
+    
+    // return f(...): hand f to the enclosing call's loop instead of nesting
+    if (node.is_tail_call) {
+        auto call = static_cast<CallExpression*>(node.value.get());
+        Value callee = evaluate(call->function.get());
+        
+        ArgumentList arguments;
+        arguments.reserve(call->arguments.size());
+        for (auto& arg : call->arguments) {
+            arguments.push_back(evaluate(arg.get()));
+        }
+        
+        if (auto function = std::get_if<Ref<CallableFunction>>(&callee)) {
+            frames.back().tail_function = *function;
+            frames.back().tail_arguments = std::move(arguments);
+        } else {
+            Value result = callValue(callee, std::move(arguments));
+            frames.back().return_value = std::move(result);
+        }
+        returning = true;
+        return;
+    }
+    
+    // Evaluate first: the frame stack may grow while the value is computed
     Value return_value = nullptr;
     if (node.value) {
         return_value = evaluate(node.value.get());
     }
-    throw ReturnException(return_value);
+    frames.back().return_value = std::move(return_value);
+    returning = true;
 }
 
 void Interpreter::visit(BreakStatement& node) {
@@ -417,43 +1180,47 @@ void Interpreter::visit(PassStatement& node) {
 }
 
 void Interpreter::visit(Program& node) {
+    GcHeap& heap = GcHeap::instance();
     for (auto& stmt : node.statements) {
+        current_statement = stmt.get();
         stmt->accept(*this);
+        heap.maybeCollect();
+        pollProfiler();
     }
 }
 
 // Helper functions
+void Interpreter::sampleStack() {
+    // Each frame runs the statement its callee was called from; the innermost runs current_statement
+    auto line = [](const Statement* statement) {
+        return statement ? statement->position.line : 0;
+    };
+    sample_stack.clear();
+    sample_stack.push_back(ProfileFrame{nullptr, 0});
+    for (const CallFrame& frame : frames) {
+        sample_stack.back().line = line(frame.caller_statement);
+        sample_stack.push_back(ProfileFrame{frame.function->getDeclaration(), 0});
+    }
+    sample_stack.back().line = line(current_statement);
+    profiler->record(sample_stack);
+}
+
 void Interpreter::initializeBuiltins() {
-    builtins["print"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("print")] = [this](const ArgumentList& args) -> Value {
         for (size_t i = 0; i < args.size(); ++i) {
             if (i > 0) std::cout << " ";
             
-            std::string output = std::visit([](const auto& v) -> std::string {
-                using T = std::decay_t<decltype(v)>;
-                if constexpr (std::is_same_v<T, std::nullptr_t>) {
-                    return "None";
-                } else if constexpr (std::is_same_v<T, bool>) {
-                    return v ? "True" : "False";
-                } else if constexpr (std::is_same_v<T, std::string>) {
-                    return v;
-                } else if constexpr (std::is_same_v<T, int64_t>) {
-                    return std::to_string(v);
-                } else if constexpr (std::is_same_v<T, double>) {
-                    return std::to_string(v);
-                } else if constexpr (std::is_same_v<T, std::shared_ptr<CallableFunction>>) {
-                    return "<function " + v->getDeclaration()->name + ">";
-                } else {
-                    return "[object]";
-                }
-            }, args[i]);
-            
-            std::cout << output;
+            if (const String* str = std::get_if<String>(&args[i])) {
+                std::cout << *str;
+            } else {
+                std::cout << valueToString(args[i]);
+            }
         }
         std::cout << std::endl;
         return nullptr;
     };
 
-    builtins["range"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("range")] = [](const ArgumentList& args) -> Value {
         if (args.empty() || args.size() > 3) {
             return nullptr; // Invalid range call
         }
@@ -483,47 +1250,39 @@ void Interpreter::initializeBuiltins() {
         }
         
         // Return a special string that ForStatement can recognize
-        return std::string("__range_" + std::to_string(start) + "_" + std::to_string(end) + "_" + std::to_string(step));
+        return String("__range_" + std::to_string(start) + "_" + std::to_string(end) + "_" + std::to_string(step));
     };
 
-    builtins["len"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("len")] = [](const ArgumentList& args) -> Value {
         if (args.size() != 1) {
             throw RuntimeError("len() takes exactly one argument");
         }
         
-        if (std::holds_alternative<std::string>(args[0])) {
-            return static_cast<int64_t>(std::get<std::string>(args[0]).length());
+        if (std::holds_alternative<String>(args[0])) {
+            return static_cast<int64_t>(std::get<String>(args[0]).size());
+        }
+        if (std::holds_alternative<Ref<ListObject>>(args[0])) {
+            return static_cast<int64_t>(std::get<Ref<ListObject>>(args[0])->size());
+        }
+        if (std::holds_alternative<Ref<DictObject>>(args[0])) {
+            return static_cast<int64_t>(std::get<Ref<DictObject>>(args[0])->size());
         }
         
         throw RuntimeError("object has no len()");
     };
 
-    builtins["str"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("str")] = [this](const ArgumentList& args) -> Value {
         if (args.size() != 1) {
             throw RuntimeError("str() takes exactly one argument");
         }
         
-        return std::visit([](const auto& v) -> std::string {
-            using T = std::decay_t<decltype(v)>;
-            if constexpr (std::is_same_v<T, std::nullptr_t>) {
-                return "None";
-            } else if constexpr (std::is_same_v<T, bool>) {
-                return v ? "True" : "False";
-            } else if constexpr (std::is_same_v<T, std::string>) {
-                return v;
-            } else if constexpr (std::is_same_v<T, int64_t>) {
-                return std::to_string(v);
-            } else if constexpr (std::is_same_v<T, double>) {
-                return std::to_string(v);
-            } else if constexpr (std::is_same_v<T, std::shared_ptr<CallableFunction>>) {
-                return "<function " + v->getDeclaration()->name + ">";
-            } else {
-                return "[object]";
-            }
-        }, args[0]);
+        if (std::holds_alternative<String>(args[0])) {
+            return args[0];
+        }
+        return String(valueToString(args[0]));
     };
 
-    builtins["int"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("int")] = [](const ArgumentList& args) -> Value {
         if (args.size() != 1) {
             throw RuntimeError("int() takes exactly one argument");
         }
@@ -532,8 +1291,8 @@ void Interpreter::initializeBuiltins() {
             return std::get<int64_t>(args[0]);
         } else if (std::holds_alternative<double>(args[0])) {
             return static_cast<int64_t>(std::get<double>(args[0]));
-        } else if (std::holds_alternative<std::string>(args[0])) {
-            std::string str_val = std::get<std::string>(args[0]);
+        } else if (std::holds_alternative<String>(args[0])) {
+            std::string str_val = std::get<String>(args[0]).str();
             
             // Handle boolean string literals
             if (str_val == "True") return static_cast<int64_t>(1);
@@ -551,7 +1310,7 @@ void Interpreter::initializeBuiltins() {
         throw RuntimeError("int() argument must be a string, a bytes-like object or a number");
     };
 
-    builtins["float"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("float")] = [](const ArgumentList& args) -> Value {
         if (args.size() != 1) {
             throw RuntimeError("float() takes exactly one argument");
         }
@@ -560,8 +1319,8 @@ void Interpreter::initializeBuiltins() {
             return std::get<double>(args[0]);
         } else if (std::holds_alternative<int64_t>(args[0])) {
             return static_cast<double>(std::get<int64_t>(args[0]));
-        } else if (std::holds_alternative<std::string>(args[0])) {
-            std::string str_val = std::get<std::string>(args[0]);
+        } else if (std::holds_alternative<String>(args[0])) {
+            std::string str_val = std::get<String>(args[0]).str();
             
             // Handle boolean string literals
             if (str_val == "True") return 1.0;
@@ -579,32 +1338,36 @@ void Interpreter::initializeBuiltins() {
         throw RuntimeError("float() argument must be a string or a number");
     };
 
-    builtins["type"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("type")] = [](const ArgumentList& args) -> Value {
         if (args.size() != 1) {
             throw RuntimeError("type() takes exactly one argument");
         }
         
-        return std::visit([](const auto& v) -> std::string {
+        return std::visit([](const auto& v) -> String {
             using T = std::decay_t<decltype(v)>;
             if constexpr (std::is_same_v<T, std::nullptr_t>) {
                 return "<class 'NoneType'>";
             } else if constexpr (std::is_same_v<T, bool>) {
                 return "<class 'bool'>";
-            } else if constexpr (std::is_same_v<T, std::string>) {
+            } else if constexpr (std::is_same_v<T, String>) {
                 return "<class 'str'>";
             } else if constexpr (std::is_same_v<T, int64_t>) {
                 return "<class 'int'>";
             } else if constexpr (std::is_same_v<T, double>) {
                 return "<class 'float'>";
-            } else if constexpr (std::is_same_v<T, std::shared_ptr<CallableFunction>>) {
+            } else if constexpr (std::is_same_v<T, Ref<CallableFunction>>) {
                 return "<class 'function'>";
+            } else if constexpr (std::is_same_v<T, Ref<ListObject>>) {
+                return "<class 'list'>";
+            } else if constexpr (std::is_same_v<T, Ref<DictObject>>) {
+                return "<class 'dict'>";
             } else {
                 return "<class 'object'>";
             }
         }, args[0]);
     };
 
-    builtins["abs"] = [](const std::vector<Value>& args) -> Value {
+    builtins[String::intern("abs")] = [](const ArgumentList& args) -> Value {
         if (args.size() != 1) {
             throw RuntimeError("abs() takes exactly one argument");
         }
@@ -619,26 +1382,123 @@ void Interpreter::initializeBuiltins() {
         
         throw RuntimeError("bad operand type for abs()");
     };
+
+    builtins[String::intern("sum")] = [](const ArgumentList& args) -> Value {
+        if (args.size() != 1) {
+            throw RuntimeError("sum() takes exactly one argument");
+        }
+        
+        auto list = std::get_if<Ref<ListObject>>(&args[0]);
+        if (!list) {
+            throw RuntimeError("sum() argument must be a list");
+        }
+        
+        const ListObject& items = **list;
+        size_t count = items.size();
+        switch (items.storage()) {
+            case ListObject::Storage::EMPTY:
+                return static_cast<int64_t>(0);
+            case ListObject::Storage::INT: {
+                // Contiguous unboxed storage: a plain loop the compiler vectorizes
+                const int64_t* data = items.intData();
+                int64_t total = 0;
+                for (size_t i = 0; i < count; i++) {
+                    total += data[i];
+                }
+                return total;
+            }
+            case ListObject::Storage::FLOAT: {
+                const double* data = items.floatData();
+                double total = 0.0;
+                for (size_t i = 0; i < count; i++) {
+                    total += data[i];
+                }
+                return total;
+            }
+            case ListObject::Storage::GENERIC:
+                break;
+        }
+        
+        int64_t int_total = 0;
+        double float_total = 0.0;
+        bool is_float = false;
+        for (size_t i = 0; i < count; i++) {
+            Value item = items.get(i);
+            if (const int64_t* v = std::get_if<int64_t>(&item)) {
+                int_total += *v;
+            } else if (const double* d = std::get_if<double>(&item)) {
+                float_total += *d;
+                is_float = true;
+            } else {
+                throw RuntimeError("unsupported operand type(s) for sum()");
+            }
+        }
+        if (is_float) {
+            return float_total + static_cast<double>(int_total);
+        }
+        return int_total;
+    };
+    
+    // Callees name builtins by reference string, so calls look them up by it directly
+    for (auto& [name, function] : builtins) {
+        builtin_references[String::intern("__builtin_" + name.str())] = BuiltinReference{&function, name};
+    }
     
     // Initialize special variables
-    environment->define("__name__", std::string("__main__"));
+    environment->define("__name__", String("__main__"));
 }
 
 std::string Interpreter::valueToString(const Value& value) {
-    return std::visit([](const auto& v) -> std::string {
+    // Elements of containers show strings quoted
+    auto repr = [this](const Value& element) -> std::string {
+        if (const String* str = std::get_if<String>(&element)) {
+            return "'" + str->str() + "'";
+        }
+        return valueToString(element);
+    };
+    
+    // A container met again while printing it prints as [...] or {...}, like Python
+    auto inside = [this](const void* container) {
+        return std::find(printing.begin(), printing.end(), container) != printing.end();
+    };
+    
+    return std::visit([this, &repr, &inside](const auto& v) -> std::string {
         using T = std::decay_t<decltype(v)>;
         if constexpr (std::is_same_v<T, std::nullptr_t>) {
             return "None";
         } else if constexpr (std::is_same_v<T, bool>) {
             return v ? "True" : "False";
-        } else if constexpr (std::is_same_v<T, std::string>) {
-            return v;
+        } else if constexpr (std::is_same_v<T, String>) {
+            return v.str();
         } else if constexpr (std::is_same_v<T, int64_t>) {
             return std::to_string(v);
         } else if constexpr (std::is_same_v<T, double>) {
             return std::to_string(v);
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<CallableFunction>>) {
+        } else if constexpr (std::is_same_v<T, Ref<CallableFunction>>) {
             return "<function " + v->getDeclaration()->name + ">";
+        } else if constexpr (std::is_same_v<T, Ref<ListObject>>) {
+            if (inside(v.get())) return "[...]";
+            printing.push_back(v.get());
+            std::string result = "[";
+            for (size_t i = 0; i < v->size(); i++) {
+                if (i > 0) result += ", ";
+                result += repr(v->get(i));
+            }
+            printing.pop_back();
+            return result + "]";
+        } else if constexpr (std::is_same_v<T, Ref<DictObject>>) {
+            if (inside(v.get())) return "{...}";
+            printing.push_back(v.get());
+            std::string result = "{";
+            bool first = true;
+            for (const auto& entry : v->entries()) {
+                if (!entry.live) continue;
+                if (!first) result += ", ";
+                result += repr(entry.key) + ": " + repr(entry.value);
+                first = false;
+            }
+            printing.pop_back();
+            return result + "}";
         } else {
             return "[object]";
         }
@@ -656,10 +1516,14 @@ bool Interpreter::isTruthy(const Value& value) {
             return v != 0;
         } else if constexpr (std::is_same_v<T, double>) {
             return v != 0.0;
-        } else if constexpr (std::is_same_v<T, std::string>) {
+        } else if constexpr (std::is_same_v<T, String>) {
             return !v.empty();
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<CallableFunction>>) {
+        } else if constexpr (std::is_same_v<T, Ref<CallableFunction>>) {
             return true; // Functions are always truthy
+        } else if constexpr (std::is_same_v<T, Ref<ListObject>>) {
+            return !v->empty();
+        } else if constexpr (std::is_same_v<T, Ref<DictObject>>) {
+            return !v->empty();
         } else {
             return true;
         }
@@ -687,9 +1551,9 @@ Value Interpreter::tokenToValue(const Token& token) {
         case TokenType::FLOAT:
             return std::stod(token.value);
         case TokenType::STRING:
-            return token.value;
+            return String(token.value);
         default:
-            return std::string(token.value);
+            return String(token.value);
     }
 }
 
@@ -0,0 +1,171 @@
+/**
+ * @file profiler.cpp
+ * @brief Sampling profiler for Caesar source code
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/profiler.h"
+#include "caesar/ast.h"
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <signal.h>
+#include <sys/time.h>
+#define CAESAR_HAS_PROFILE_TIMER 1
+#endif
+
+namespace caesar {
+
+namespace {
+
+#ifdef CAESAR_HAS_PROFILE_TIMER
+void handleProfileSignal(int) {
+    SamplingProfiler::tick();
+}
+
+void setTimer(long interval_us) {
+    itimerval timer{};
+    timer.it_interval.tv_sec = interval_us / 1000000;
+    timer.it_interval.tv_usec = interval_us % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+#endif
+
+std::string frameName(const ProfileFrame& frame) {
+    std::string name = frame.function ? frame.function->name : "<module>";
+    if (frame.line != 0) {
+        name += ":" + std::to_string(frame.line);
+    }
+    return name;
+}
+
+} // anonymous namespace
+
+size_t SamplingProfiler::StackHash::operator()(const std::vector<ProfileFrame>& stack) const {
+    size_t hash = stack.size();
+    for (const ProfileFrame& frame : stack) {
+        hash = hash * 31 + std::hash<const void*>()(frame.function);
+        hash = hash * 31 + frame.line;
+    }
+    return hash;
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+}
+
+bool SamplingProfiler::start(int frequency_hz) {
+#ifdef CAESAR_HAS_PROFILE_TIMER
+    if (running_ || frequency_hz <= 0) return false;
+
+    struct sigaction action{};
+    action.sa_handler = handleProfileSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &action, nullptr) != 0) return false;
+
+    pending_ticks_.store(0, std::memory_order_relaxed);
+    setTimer(std::max(1L, 1000000L / frequency_hz));
+    running_ = true;
+    return true;
+#else
+    (void)frequency_hz;
+    return false;
+#endif
+}
+
+void SamplingProfiler::stop() {
+#ifdef CAESAR_HAS_PROFILE_TIMER
+    if (!running_) return;
+    setTimer(0);
+    // Ignoring rather than restoring the default drops a tick still in flight
+    signal(SIGPROF, SIG_IGN);
+    running_ = false;
+#endif
+}
+
+void SamplingProfiler::record(const std::vector<ProfileFrame>& stack) {
+    uint32_t ticks = pending_ticks_.exchange(0, std::memory_order_relaxed);
+    if (ticks == 0) return;
+    stacks_[stack] += ticks;
+    samples_ += ticks;
+}
+
+void SamplingProfiler::writeFolded(std::ostream& out) const {
+    std::vector<std::pair<std::string, uint64_t>> lines;
+    lines.reserve(stacks_.size());
+    for (const auto& [stack, count] : stacks_) {
+        std::string folded;
+        for (const ProfileFrame& frame : stack) {
+            if (!folded.empty()) folded += ";";
+            folded += frameName(frame);
+        }
+        lines.emplace_back(std::move(folded), count);
+    }
+    std::sort(lines.begin(), lines.end());
+
+    for (const auto& [folded, count] : lines) {
+        out << folded << " " << count << "\n";
+    }
+}
+
+void FunctionProfiler::enter(const void* key, std::string_view name) {
+    FunctionStats& stats = functions_[key];
+    if (stats.calls == 0) stats.name = name;
+    stats.calls++;
+    if (stats.active++ == 0) stats.outermost_calls++;
+    activations_.push_back(Activation{&stats, Clock::now(), Clock::duration(0)});
+}
+
+void FunctionProfiler::exit() {
+    Activation activation = activations_.back();
+    activations_.pop_back();
+    Clock::duration elapsed = Clock::now() - activation.start;
+
+    FunctionStats& stats = *activation.stats;
+    stats.self += elapsed - activation.children;
+    if (--stats.active == 0) stats.total += elapsed;
+    if (!activations_.empty()) activations_.back().children += elapsed;
+}
+
+std::vector<const FunctionProfiler::FunctionStats*> FunctionProfiler::sortedStats() const {
+    std::vector<const FunctionStats*> sorted;
+    sorted.reserve(functions_.size());
+    for (const auto& entry : functions_) {
+        sorted.push_back(&entry.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const FunctionStats* a, const FunctionStats* b) {
+        return a->self != b->self ? a->self > b->self : a->name < b->name;
+    });
+    return sorted;
+}
+
+void FunctionProfiler::printTable(std::ostream& out) const {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    using Microseconds = std::chrono::duration<double, std::micro>;
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::left << std::setw(28) << "function" << std::right << std::setw(12) << "calls"
+        << std::setw(14) << "total ms" << std::setw(14) << "self ms" << std::setw(16)
+        << "us/outer call" << "\n";
+    out << std::fixed << std::setprecision(3);
+    for (const FunctionStats* stats : sortedStats()) {
+        Microseconds per_outer_call = stats->total / static_cast<double>(stats->outermost_calls);
+        out << std::left << std::setw(28) << stats->name << std::right << std::setw(12)
+            << stats->calls << std::setw(14) << Milliseconds(stats->total).count()
+            << std::setw(14) << Milliseconds(stats->self).count() << std::setw(16)
+            << per_outer_call.count() << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace caesar
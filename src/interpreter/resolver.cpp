@@ -0,0 +1,287 @@
+/**
+ * @file resolver.cpp
+ * @brief Scope analysis assigning locals to registers and captures to upvalues
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/resolver.h"
+#include <algorithm>
+
+namespace caesar {
+
+namespace {
+
+int32_t indexOf(const std::vector<String>& names, const String& name) {
+    auto it = std::find(names.begin(), names.end(), name);
+    return it == names.end() ? -1 : static_cast<int32_t>(it - names.begin());
+}
+
+int32_t addUpvalue(std::vector<UpvalueDescriptor>& upvalues, const String& name,
+                   bool from_parent_local, int32_t index) {
+    for (size_t i = 0; i < upvalues.size(); i++) {
+        if (upvalues[i].from_parent_local == from_parent_local &&
+            upvalues[i].index == static_cast<uint32_t>(index)) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    upvalues.push_back(UpvalueDescriptor{name, from_parent_local, static_cast<uint32_t>(index)});
+    return static_cast<int32_t>(upvalues.size() - 1);
+}
+
+} // anonymous namespace
+
+void Resolver::resolve(FunctionDefinition& function) {
+    if (function.resolved) return;
+
+    Resolver resolver;
+    resolver.resolveFunction(function);
+}
+
+void Resolver::resolveFunction(FunctionDefinition& function) {
+    Scope scope;
+    scopes.push_back(&scope);
+
+    // Defaults name variables of the defining scope, so resolve them before
+    // any of this function's own locals exist
+    for (auto& param : function.parameters) {
+        if (param.default_value) {
+            param.default_value->accept(*this);
+        }
+    }
+    for (auto& param : function.parameters) {
+        declare(param.symbol);
+    }
+
+    collecting = true;
+    function.body->accept(*this);
+    collecting = false;
+    function.body->accept(*this);
+
+    // Nested functions have been resolved by now, so captures are final
+    auto kindOf = [&scope](int32_t slot) {
+        return scope.captured[static_cast<size_t>(slot)] ? VariableKind::CELL : VariableKind::LOCAL;
+    };
+    for (IdentifierExpression* identifier : scope.identifiers) {
+        identifier->kind = kindOf(identifier->slot);
+    }
+    for (ForStatement* loop : scope.loops) {
+        loop->variable_kind = kindOf(loop->variable_slot);
+    }
+    for (FunctionDefinition* nested : scope.functions) {
+        nested->name_kind = kindOf(nested->name_slot);
+    }
+    for (ClassDefinition* definition : scope.classes) {
+        definition->name_kind = kindOf(definition->name_slot);
+    }
+
+    function.cell_slots.clear();
+    for (size_t i = 0; i < scope.captured.size(); i++) {
+        if (scope.captured[i]) {
+            function.cell_slots.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    function.slot_names = std::move(scope.locals);
+    function.upvalues = std::move(scope.upvalues);
+    function.resolved = true;
+
+    scopes.pop_back();
+}
+
+void Resolver::declare(const String& name) {
+    Scope& scope = *scopes.back();
+    if (indexOf(scope.locals, name) < 0) {
+        scope.locals.push_back(name);
+        scope.captured.push_back(false);
+    }
+}
+
+int32_t Resolver::declaringScope(size_t below, const String& name) const {
+    for (size_t depth = below; depth-- > 0;) {
+        if (indexOf(scopes[depth]->locals, name) >= 0) return static_cast<int32_t>(depth);
+    }
+    return -1;
+}
+
+int32_t Resolver::capture(size_t depth, size_t owner, const String& name) {
+    if (owner + 1 == depth) {
+        Scope& enclosing = *scopes[owner];
+        int32_t local = indexOf(enclosing.locals, name);
+        enclosing.captured[static_cast<size_t>(local)] = true;
+        return addUpvalue(scopes[depth]->upvalues, name, true, local);
+    }
+
+    // Capture it from further out, threading it through the enclosing function
+    int32_t outer = capture(depth - 1, owner, name);
+    return addUpvalue(scopes[depth]->upvalues, name, false, outer);
+}
+
+void Resolver::bindLocal(IdentifierExpression& identifier, bool reading) {
+    size_t depth = scopes.size() - 1;
+    int32_t owner = static_cast<int32_t>(depth);
+    int32_t local = indexOf(scopes[depth]->locals, identifier.symbol);
+    identifier.fallbacks.clear();
+    if (local >= 0) {
+        identifier.kind = VariableKind::LOCAL;
+        identifier.slot = local;
+        scopes[depth]->identifiers.push_back(&identifier);
+    } else if ((owner = declaringScope(depth, identifier.symbol)) >= 0) {
+        identifier.kind = VariableKind::UPVALUE;
+        identifier.slot = capture(depth, static_cast<size_t>(owner), identifier.symbol);
+    } else {
+        identifier.kind = VariableKind::NAME;
+        identifier.slot = -1;
+        return;
+    }
+    if (!reading) return;
+
+    // Until the variable is assigned, reads see the same name further out
+    while ((owner = declaringScope(static_cast<size_t>(owner), identifier.symbol)) >= 0) {
+        identifier.fallbacks.push_back(capture(depth, static_cast<size_t>(owner), identifier.symbol));
+    }
+}
+
+// Expression visitors
+void Resolver::visit(LiteralExpression& node) {
+    (void)node;
+}
+
+void Resolver::visit(IdentifierExpression& node) {
+    if (!collecting) {
+        bindLocal(node, true);
+    }
+}
+
+void Resolver::visit(BinaryExpression& node) {
+    node.left->accept(*this);
+    node.right->accept(*this);
+}
+
+void Resolver::visit(UnaryExpression& node) {
+    node.operand->accept(*this);
+}
+
+void Resolver::visit(CallExpression& node) {
+    node.function->accept(*this);
+    for (auto& arg : node.arguments) {
+        arg->accept(*this);
+    }
+}
+
+void Resolver::visit(MemberExpression& node) {
+    node.object->accept(*this);
+}
+
+void Resolver::visit(IndexExpression& node) {
+    node.object->accept(*this);
+    node.index->accept(*this);
+}
+
+void Resolver::visit(AssignmentExpression& node) {
+    // Assigning a plain name makes it local; other targets only read names
+    if (auto identifier = dynamic_cast<IdentifierExpression*>(node.target.get())) {
+        if (collecting) {
+            declare(identifier->symbol);
+        } else {
+            bindLocal(*identifier, false);
+        }
+    } else {
+        node.target->accept(*this);
+    }
+    node.value->accept(*this);
+}
+
+void Resolver::visit(ListExpression& node) {
+    for (auto& element : node.elements) {
+        element->accept(*this);
+    }
+}
+
+void Resolver::visit(DictExpression& node) {
+    for (auto& pair : node.pairs) {
+        pair.first->accept(*this);
+        pair.second->accept(*this);
+    }
+}
+
+// Statement visitors
+void Resolver::visit(ExpressionStatement& node) {
+    node.expression->accept(*this);
+}
+
+void Resolver::visit(BlockStatement& node) {
+    for (auto& stmt : node.statements) {
+        stmt->accept(*this);
+    }
+}
+
+void Resolver::visit(IfStatement& node) {
+    node.condition->accept(*this);
+    node.then_block->accept(*this);
+    if (node.else_block) {
+        node.else_block->accept(*this);
+    }
+}
+
+void Resolver::visit(WhileStatement& node) {
+    node.condition->accept(*this);
+    node.body->accept(*this);
+}
+
+void Resolver::visit(ForStatement& node) {
+    if (collecting) {
+        declare(node.variable_symbol);
+    } else {
+        node.variable_slot = indexOf(scopes.back()->locals, node.variable_symbol);
+        scopes.back()->loops.push_back(&node);
+    }
+    node.iterable->accept(*this);
+    node.body->accept(*this);
+}
+
+void Resolver::visit(FunctionDefinition& node) {
+    if (collecting) {
+        declare(String::intern(node.name));
+        return;
+    }
+
+    // The nested body is resolved once all locals of this scope are known
+    node.name_slot = indexOf(scopes.back()->locals, String::intern(node.name));
+    scopes.back()->functions.push_back(&node);
+    resolveFunction(node);
+}
+
+void Resolver::visit(ClassDefinition& node) {
+    if (collecting) {
+        declare(String::intern(node.name));
+    } else {
+        node.name_slot = indexOf(scopes.back()->locals, String::intern(node.name));
+        scopes.back()->classes.push_back(&node);
+    }
+}
+
+void Resolver::visit(ReturnStatement& node) {
+    if (node.value) {
+        node.value->accept(*this);
+    }
+}
+
+void Resolver::visit(BreakStatement& node) {
+    (void)node;
+}
+
+void Resolver::visit(ContinueStatement& node) {
+    (void)node;
+}
+
+void Resolver::visit(PassStatement& node) {
+    (void)node;
+}
+
+void Resolver::visit(Program& node) {
+    for (auto& stmt : node.statements) {
+        stmt->accept(*this);
+    }
+}
+
+} // namespace caesar
@@ -0,0 +1,92 @@
+/**
+ * @file tracer.cpp
+ * @brief Chrome trace-event recording of Caesar calls
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/tracer.h"
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+namespace caesar {
+
+namespace {
+
+const char* categoryName(TraceCategory category) {
+    switch (category) {
+        case TraceCategory::FUNCTION: return "function";
+        case TraceCategory::BUILTIN: return "builtin";
+        case TraceCategory::LOOP: return "loop";
+        default: return "unknown";
+    }
+}
+
+void writeJsonString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // anonymous namespace
+
+Tracer::Tracer(size_t capacity, bool trace_loops)
+    : start_(std::chrono::steady_clock::now()), trace_loops_(trace_loops) {
+    size_t rounded = 1;
+    while (rounded < capacity) rounded <<= 1;
+    events_.reset(new Event[rounded]);
+    mask_ = rounded - 1;
+}
+
+void Tracer::writeJson(std::ostream& out) const {
+    uint64_t first = recorded_ - std::min<uint64_t>(recorded_, capacity());
+    size_t depth = 0;
+
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    const char* separator = "\n";
+    for (uint64_t i = first; i < recorded_; i++) {
+        const Event& event = events_[i & mask_];
+        if (event.phase == 'E') {
+            if (depth == 0) continue;  // Began before the oldest kept event
+            depth--;
+        } else {
+            depth++;
+        }
+
+        out << separator << "{";
+        if (event.phase == 'B') {
+            std::string_view name(event.name, event.name_length);
+            out << "\"name\": ";
+            if (event.category == TraceCategory::LOOP) {
+                writeJsonString(out, std::string(name) + " line " + std::to_string(event.line));
+            } else {
+                writeJsonString(out, name);
+            }
+            out << ", ";
+        }
+
+        // Microseconds with nanosecond precision
+        char timestamp[32];
+        std::snprintf(timestamp, sizeof(timestamp), "%lld.%03lld",
+                      static_cast<long long>(event.timestamp_ns / 1000),
+                      static_cast<long long>(event.timestamp_ns % 1000));
+        out << "\"cat\": \"" << categoryName(event.category) << "\", \"ph\": \""
+            << event.phase << "\", \"ts\": " << timestamp << ", \"pid\": 1, \"tid\": 1}";
+        separator = ",\n";
+    }
+    out << "\n]}\n";
+}
+
+} // namespace caesar
@@ -9,9 +9,15 @@
 #include "caesar/lexer.h"
 #include "caesar/parser.h"
 #include "caesar/interpreter.h"
+#include "caesar/profiler.h"
+#include "caesar/execution_stats.h"
+#include "caesar/tracer.h"
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <string>
 
 void printUsage(const char* program_name) {
     std::cout << "Caesar Programming Language v" << caesar::Version::STRING << "\n";
@@ -22,7 +28,23 @@ void printUsage(const char* program_name) {
     std::cout << "  -t, --tokens     Show tokenization output\n";
     std::cout << "  -p, --parse      Show parsing output (AST)\n";
     std::cout << "  -i, --interpret  Execute the program using the interpreter\n";
-    std::cout << "  -o <output>      Specify output file (for future use)\n\n";
+    std::cout << "  -o <output>      Specify output file (for future use)\n";
+    std::cout << "  --max-recursion <n>\n";
+    std::cout << "                   Maximum depth of nested function calls (default "
+              << caesar::Interpreter::DEFAULT_MAX_RECURSION << ")\n";
+    std::cout << "  --gc-stats       Print garbage collector statistics on exit\n";
+    std::cout << "  --mem-stats      Print allocator statistics on exit\n";
+    std::cout << "  --gc-max-pause-us <n>\n";
+    std::cout << "                   Collect incrementally, pausing at most about n microseconds\n";
+    std::cout << "  --profile=<file> Sample the Caesar call stack " << caesar::SamplingProfiler::DEFAULT_FREQUENCY_HZ
+              << " times per CPU second\n";
+    std::cout << "                   and write it as folded stacks for flame graphs\n";
+    std::cout << "  --profile=functions\n";
+    std::cout << "                   Count and time every function call, print a table on exit\n";
+    std::cout << "  --stats[=<file>] Count node visits and binary operand types, print them on exit\n";
+    std::cout << "                   or write them to file as JSON\n";
+    std::cout << "  --trace=<file>   Write every function and builtin call to file as a Chrome trace\n";
+    std::cout << "  --trace-loops    With --trace, also record each while and for loop\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << program_name << " --interpret program.csr    # Run program\n";
     std::cout << "  " << program_name << " --parse program.csr        # Show AST\n";
@@ -54,6 +76,15 @@ int main(int argc, char* argv[]) {
     bool interpret = false;
     std::string input_file;
     std::string output_file;
+    size_t max_recursion = caesar::Interpreter::DEFAULT_MAX_RECURSION;
+    bool gc_stats = false;
+    bool mem_stats = false;
+    long long gc_max_pause_us = 0;
+    std::string profile_output;
+    bool execution_stats = false;
+    std::string stats_output;
+    std::string trace_output;
+    bool trace_loops = false;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -73,6 +104,74 @@ int main(int argc, char* argv[]) {
             interpret = true;
         } else if (arg == "-o" && i + 1 < argc) {
             output_file = argv[++i];
+        } else if (arg == "--max-recursion" || arg.rfind("--max-recursion=", 0) == 0) {
+            std::string value;
+            if (arg.size() > 15) {
+                value = arg.substr(16);
+            } else if (i + 1 < argc) {
+                value = argv[++i];
+            }
+            
+            try {
+                size_t parsed = 0;
+                long long depth = std::stoll(value, &parsed);
+                if (parsed != value.size() || depth <= 0) {
+                    throw std::invalid_argument(value);
+                }
+                max_recursion = static_cast<size_t>(depth);
+            } catch (const std::exception&) {
+                std::cerr << "Error: --max-recursion expects a positive integer\n";
+                return 1;
+            }
+        } else if (arg == "--gc-stats") {
+            gc_stats = true;
+        } else if (arg == "--mem-stats") {
+            mem_stats = true;
+        } else if (arg == "--gc-max-pause-us" || arg.rfind("--gc-max-pause-us=", 0) == 0) {
+            std::string value;
+            if (arg.size() > 17) {
+                value = arg.substr(18);
+            } else if (i + 1 < argc) {
+                value = argv[++i];
+            }
+            
+            try {
+                size_t parsed = 0;
+                gc_max_pause_us = std::stoll(value, &parsed);
+                if (parsed != value.size() || gc_max_pause_us <= 0) {
+                    throw std::invalid_argument(value);
+                }
+            } catch (const std::exception&) {
+                std::cerr << "Error: --gc-max-pause-us expects a positive integer\n";
+                return 1;
+            }
+        } else if (arg == "--profile" || arg.rfind("--profile=", 0) == 0) {
+            if (arg.size() > 9) {
+                profile_output = arg.substr(10);
+            } else if (i + 1 < argc) {
+                profile_output = argv[++i];
+            }
+            
+            if (profile_output.empty()) {
+                std::cerr << "Error: --profile expects an output file\n";
+                return 1;
+            }
+        } else if (arg == "--stats" || arg.rfind("--stats=", 0) == 0) {
+            execution_stats = true;
+            stats_output = arg.size() > 7 ? arg.substr(8) : "";
+        } else if (arg == "--trace" || arg.rfind("--trace=", 0) == 0) {
+            if (arg.size() > 7) {
+                trace_output = arg.substr(8);
+            } else if (i + 1 < argc) {
+                trace_output = argv[++i];
+            }
+            
+            if (trace_output.empty()) {
+                std::cerr << "Error: --trace expects an output file\n";
+                return 1;
+            }
+        } else if (arg == "--trace-loops") {
+            trace_loops = true;
         } else if (arg[0] != '-') {
             input_file = arg;
         } else {
@@ -123,9 +222,79 @@ int main(int argc, char* argv[]) {
         }
         
         if (interpret) {
-            // Interpret the program
-            caesar::Interpreter interpreter;
-            interpreter.interpret(program.get());
+            caesar::GcHeap::instance().setMaxPause(std::chrono::microseconds(gc_max_pause_us));
+            
+            // --profile=functions selects exact timing; any other value is the sampler's output file
+            bool profile_functions = profile_output == "functions";
+            bool profile_samples = !profile_output.empty() && !profile_functions;
+            caesar::FunctionProfiler function_profiler;
+            caesar::SamplingProfiler profiler;
+            caesar::ExecutionStats stats;
+            std::unique_ptr<caesar::Tracer> tracer;
+            if (!trace_output.empty()) {
+                tracer = std::make_unique<caesar::Tracer>(caesar::Tracer::DEFAULT_CAPACITY, trace_loops);
+            }
+            if (profile_samples && !profiler.start()) {
+                std::cerr << "Error: --profile is not supported on this platform\n";
+                return 1;
+            }
+            
+            // Interpret the program; destroying the interpreter runs a final collection
+            {
+                std::unique_ptr<caesar::Interpreter> interpreter;
+                if (execution_stats) {
+                    interpreter = std::make_unique<caesar::CountingInterpreter>(stats);
+                } else {
+                    interpreter = std::make_unique<caesar::Interpreter>();
+                }
+                interpreter->setMaxRecursion(max_recursion);
+                interpreter->setProfiler(profile_samples ? &profiler : nullptr);
+                interpreter->setFunctionProfiler(profile_functions ? &function_profiler : nullptr);
+                interpreter->setTracer(tracer.get());
+                interpreter->interpret(program.get());
+                profiler.stop();
+            }
+            
+            if (execution_stats && stats_output.empty()) {
+                stats.printReport(std::cerr);
+            } else if (execution_stats) {
+                std::ofstream stats_file(stats_output);
+                if (!stats_file.is_open()) {
+                    std::cerr << "Error: Cannot write stats to '" << stats_output << "'\n";
+                    return 1;
+                }
+                stats.writeJson(stats_file);
+            }
+            if (tracer) {
+                std::ofstream trace_file(trace_output);
+                if (!trace_file.is_open()) {
+                    std::cerr << "Error: Cannot write trace to '" << trace_output << "'\n";
+                    return 1;
+                }
+                tracer->writeJson(trace_file);
+                if (tracer->droppedCount() > 0) {
+                    std::cerr << "Trace: kept the last " << tracer->capacity() << " of "
+                              << tracer->recordedCount() << " events\n";
+                }
+            }
+            if (profile_functions) {
+                function_profiler.printTable(std::cerr);
+            }
+            if (profile_samples) {
+                std::ofstream profile(profile_output);
+                if (!profile.is_open()) {
+                    std::cerr << "Error: Cannot write profile to '" << profile_output << "'\n";
+                    return 1;
+                }
+                profiler.writeFolded(profile);
+            }
+            
+            if (gc_stats) {
+                caesar::GcHeap::instance().printStats(std::cerr);
+            }
+            if (mem_stats) {
+                caesar::MemoryPool::instance().printStats(std::cerr);
+            }
         } else {
             std::cout << "Successfully parsed " << tokens.size() << " tokens from '" 
                       << input_file << "'\n";
@@ -93,6 +93,15 @@ std::string MemberExpression::toString() const {
     return "Member(" + object->toString() + "." + member + ")";
 }
 
+// IndexExpression
+void IndexExpression::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+std::string IndexExpression::toString() const {
+    return "Index(" + object->toString() + "[" + index->toString() + "])";
+}
+
 // AssignmentExpression
 void AssignmentExpression::accept(ASTVisitor& visitor) {
     visitor.visit(*this);
@@ -211,14 +211,14 @@ std::unique_ptr<IfStatement> Parser::ifStatement() {
 }
 
 std::unique_ptr<WhileStatement> Parser::whileStatement() {
+    Position pos = previous().position;
     auto condition = expression();
     consume(TokenType::COLON, "Expected ':' after while condition");
     consume(TokenType::NEWLINE, "Expected newline after ':'");
     
     auto body = blockStatement();
     
-    return std::make_unique<WhileStatement>(std::move(condition), std::move(body),
-                                          previous().position);
+    return std::make_unique<WhileStatement>(std::move(condition), std::move(body), pos);
 }
 
 std::unique_ptr<ForStatement> Parser::forStatement() {
@@ -262,6 +262,9 @@ std::unique_ptr<PassStatement> Parser::passStatement() {
 }
 
 std::unique_ptr<BlockStatement> Parser::blockStatement() {
+    // Comment-only lines between the ':' and the first statement produce
+    // bare NEWLINE tokens ahead of the INDENT
+    skipNewlines();
     consume(TokenType::INDENT, "Expected indented block");
     
     std::vector<std::unique_ptr<Statement>> statements;
@@ -418,6 +421,11 @@ std::unique_ptr<Expression> Parser::call() {
         } else if (match({TokenType::DOT})) {
             Token name = consume(TokenType::IDENTIFIER, "Expected property name after '.'");
             expr = std::make_unique<MemberExpression>(std::move(expr), name.value, name.position);
+        } else if (match({TokenType::LBRACKET})) {
+            Position pos = previous().position;
+            auto index = expression();
+            consume(TokenType::RBRACKET, "Expected ']' after index");
+            expr = std::make_unique<IndexExpression>(std::move(expr), std::move(index), pos);
         } else {
             break;
         }
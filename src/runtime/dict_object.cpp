@@ -0,0 +1,230 @@
+/**
+ * @file dict_object.cpp
+ * @brief Runtime dict implementation
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/dict_object.h"
+#include "caesar/list_object.h"
+#include <cmath>
+#include <functional>
+
+namespace caesar {
+
+namespace {
+
+/// Smallest index table allocated for a non-empty dict
+constexpr size_t MIN_TABLE_SIZE = 8;
+
+/// Hash of None, an arbitrary constant
+constexpr size_t NONE_HASH = 0x9e3779b97f4a7c15ULL;
+
+bool isNumber(const Value& value) {
+    return std::holds_alternative<int64_t>(value) ||
+           std::holds_alternative<double>(value) ||
+           std::holds_alternative<bool>(value);
+}
+
+double numberAsDouble(const Value& value) {
+    if (auto i = std::get_if<int64_t>(&value)) return static_cast<double>(*i);
+    if (auto d = std::get_if<double>(&value)) return *d;
+    return std::get<bool>(value) ? 1.0 : 0.0;
+}
+
+int64_t numberAsInt(const Value& value) {
+    if (auto i = std::get_if<int64_t>(&value)) return *i;
+    return std::get<bool>(value) ? 1 : 0;
+}
+
+} // anonymous namespace
+
+size_t DictObject::hashInt(int64_t key) {
+    // Finalizer of MurmurHash3: sequential ints must not cluster under linear probing
+    uint64_t x = static_cast<uint64_t>(key);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+}
+
+size_t DictObject::hashKey(const Value& key) {
+    return std::visit([](const auto& v) -> size_t {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            return NONE_HASH;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return hashInt(v ? 1 : 0);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return hashInt(v);
+        } else if constexpr (std::is_same_v<T, double>) {
+            // Integral floats hash like the equal int
+            if (std::trunc(v) == v && std::fabs(v) < 9.2e18) {
+                return hashInt(static_cast<int64_t>(v));
+            }
+            return std::hash<double>()(v);
+        } else if constexpr (std::is_same_v<T, String>) {
+            return v.hash();
+        } else if constexpr (std::is_same_v<T, Ref<ListObject>>) {
+            throw RuntimeError("unhashable type: 'list'");
+        } else if constexpr (std::is_same_v<T, Ref<DictObject>>) {
+            throw RuntimeError("unhashable type: 'dict'");
+        } else {
+            // Functions hash by identity
+            return v.hash();
+        }
+    }, key);
+}
+
+bool DictObject::keysEqual(const Value& a, const Value& b) {
+    if (a.index() != b.index()) {
+        if (!isNumber(a) || !isNumber(b)) return false;
+        if (std::holds_alternative<double>(a) || std::holds_alternative<double>(b)) {
+            return numberAsDouble(a) == numberAsDouble(b);
+        }
+        return numberAsInt(a) == numberAsInt(b);
+    }
+    return a == b;
+}
+
+template <typename Equal>
+int64_t DictObject::probe(size_t hash, Equal equal) const {
+    if (indices_.empty()) return -1;
+
+    // The load factor keeps at least one EMPTY_SLOT, so the loop terminates
+    size_t mask = indices_.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        int32_t index = indices_[slot];
+        if (index == EMPTY_SLOT) return -1;
+        if (index >= 0) {
+            const Entry& entry = entries_[static_cast<size_t>(index)];
+            if (entry.hash == hash && equal(entry.key)) {
+                return static_cast<int64_t>(slot);
+            }
+        }
+    }
+}
+
+size_t DictObject::freeSlot(size_t hash) const {
+    size_t mask = indices_.size() - 1;
+    size_t slot = hash & mask;
+    while (indices_[slot] >= 0) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+const Value* DictObject::find(const String& key) const {
+    int64_t slot = probe(key.hash(), [&key](const Value& candidate) {
+        const String* s = std::get_if<String>(&candidate);
+        return s && *s == key;
+    });
+    return slot < 0 ? nullptr : &entries_[static_cast<size_t>(indices_[slot])].value;
+}
+
+const Value* DictObject::find(int64_t key) const {
+    int64_t slot = probe(hashInt(key), [key](const Value& candidate) {
+        if (const int64_t* i = std::get_if<int64_t>(&candidate)) return *i == key;
+        return keysEqual(candidate, key);
+    });
+    return slot < 0 ? nullptr : &entries_[static_cast<size_t>(indices_[slot])].value;
+}
+
+const Value* DictObject::find(const Value& key) const {
+    if (const int64_t* i = std::get_if<int64_t>(&key)) return find(*i);
+    if (const String* s = std::get_if<String>(&key)) return find(*s);
+
+    int64_t slot = probe(hashKey(key), [&key](const Value& candidate) {
+        return keysEqual(candidate, key);
+    });
+    return slot < 0 ? nullptr : &entries_[static_cast<size_t>(indices_[slot])].value;
+}
+
+void DictObject::set(const Value& key, const Value& value) {
+    GcHeap::writeBarrier(key);
+    GcHeap::writeBarrier(value);
+    size_t hash = hashKey(key);
+    int64_t slot = probe(hash, [&key](const Value& candidate) {
+        return keysEqual(candidate, key);
+    });
+    if (slot >= 0) {
+        entries_[static_cast<size_t>(indices_[slot])].value = value;
+        return;
+    }
+
+    // Tombstones count against the load factor until a rebuild drops them
+    if ((entries_.size() + 1) * 3 > indices_.size() * 2) {
+        rebuild(size_ * 2 + 1);
+    }
+
+    indices_[freeSlot(hash)] = static_cast<int32_t>(entries_.size());
+    entries_.push_back(Entry{hash, key, value, true});
+    size_++;
+}
+
+bool DictObject::remove(const Value& key, Value* removed) {
+    int64_t slot = probe(hashKey(key), [&key](const Value& candidate) {
+        return keysEqual(candidate, key);
+    });
+    if (slot < 0) return false;
+
+    Entry& entry = entries_[static_cast<size_t>(indices_[slot])];
+    if (removed) {
+        *removed = std::move(entry.value);
+    }
+    entry.key = nullptr;
+    entry.value = nullptr;
+    entry.live = false;
+    indices_[slot] = DELETED_SLOT;
+    size_--;
+    return true;
+}
+
+void DictObject::reserve(size_t count) {
+    if (count * 3 > indices_.size() * 2) {
+        rebuild(count);
+    }
+}
+
+void DictObject::rebuild(size_t min_entries) {
+    size_t table_size = MIN_TABLE_SIZE;
+    while (table_size * 2 < min_entries * 3) {
+        table_size *= 2;
+    }
+
+    // Compact the entry array, dropping tombstones
+    if (size_ != entries_.size()) {
+        size_t kept = 0;
+        for (size_t i = 0; i < entries_.size(); i++) {
+            if (entries_[i].live) {
+                if (kept != i) entries_[kept] = std::move(entries_[i]);
+                kept++;
+            }
+        }
+        entries_.resize(kept);
+    }
+    entries_.reserve(table_size * 2 / 3);
+
+    indices_.assign(table_size, EMPTY_SLOT);
+    for (size_t i = 0; i < entries_.size(); i++) {
+        indices_[freeSlot(entries_[i].hash)] = static_cast<int32_t>(i);
+    }
+}
+
+void DictObject::traverse(GcVisitor& visitor) const {
+    // Removed entries hold None
+    for (const Entry& entry : entries_) {
+        visitor.visitValue(entry.key);
+        visitor.visitValue(entry.value);
+    }
+}
+
+void DictObject::clearReferences() {
+    entries_.clear();
+    indices_.clear();
+    size_ = 0;
+}
+
+} // namespace caesar
@@ -0,0 +1,499 @@
+/**
+ * @file gc.cpp
+ * @brief Cycle collector for reference-counted runtime objects
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/gc.h"
+#include "caesar/dict_object.h"
+#include "caesar/interpreter.h"
+#include "caesar/list_object.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+namespace caesar {
+
+namespace {
+
+/// gc_refs of objects not owned by any Ref, such as stack objects
+constexpr int64_t UNOWNED_REFS = INT64_MAX / 2;
+
+/// Units of incremental work between checks of the clock
+constexpr size_t WORK_PER_CLOCK_CHECK = 64;
+
+/// Units of incremental work owed per object the old generation grows by.
+/// A cycle makes about five passes over the old generation, so it ends
+/// before the old generation has grown by half the size it started with.
+constexpr size_t WORK_PER_OLD_GROWTH = 10;
+
+/// Young objects assumed collected per microsecond until one has been timed
+constexpr size_t YOUNG_OBJECTS_PER_US = 2;
+
+/// Smallest young threshold in incremental mode
+constexpr size_t MIN_YOUNG_THRESHOLD = 100;
+
+int64_t strongCount(GcObject* object) {
+    uint32_t owners = object->refCount();
+    return owners > 0 ? owners : UNOWNED_REFS;
+}
+
+} // anonymous namespace
+
+void GcVisitor::visitValue(const Value& value) {
+    if (auto function = std::get_if<Ref<CallableFunction>>(&value)) {
+        if (*function) visit(function->get());
+    } else if (auto list = std::get_if<Ref<ListObject>>(&value)) {
+        if (*list) visit(list->get());
+    } else if (auto dict = std::get_if<Ref<DictObject>>(&value)) {
+        if (*dict) visit(dict->get());
+    }
+}
+
+double GcStats::pausePercentile(double percentile) const {
+    if (pauses_us.empty()) return 0.0;
+
+    std::vector<float> sorted(pauses_us);
+    std::sort(sorted.begin(), sorted.end());
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+    return sorted[rank == 0 ? 0 : std::min(rank, sorted.size()) - 1];
+}
+
+GcObject::GcObject() {
+    GcHeap::instance().track(this);
+}
+
+GcObject::~GcObject() {
+    GcHeap::instance().untrack(this);
+}
+
+GcHeap& GcHeap::instance() {
+    static GcHeap* heap = new GcHeap();
+    return *heap;
+}
+
+void GcHeap::link(GcObject* object, uint8_t generation) {
+    object->gc_generation = generation;
+    object->gc_prev = nullptr;
+    object->gc_next = first_[generation];
+    if (first_[generation]) {
+        first_[generation]->gc_prev = object;
+    } else {
+        last_[generation] = object;
+    }
+    first_[generation] = object;
+    count_[generation == YOUNG ? YOUNG : OLD]++;
+}
+
+void GcHeap::track(GcObject* object) {
+    link(object, YOUNG);
+}
+
+void GcHeap::untrack(GcObject* object) {
+    if (object == cursor_) cursor_ = object->gc_next;
+
+    // Old objects may sit in either old list, so find the list by its ends
+    if (object->gc_prev) {
+        object->gc_prev->gc_next = object->gc_next;
+    } else {
+        for (GcObject*& first : first_) {
+            if (first == object) {
+                first = object->gc_next;
+                break;
+            }
+        }
+    }
+    if (object->gc_next) {
+        object->gc_next->gc_prev = object->gc_prev;
+    } else {
+        for (GcObject*& last : last_) {
+            if (last == object) {
+                last = object->gc_prev;
+                break;
+            }
+        }
+    }
+    count_[object->gc_generation == YOUNG ? YOUNG : OLD]--;
+}
+
+bool GcHeap::fullCollectionDue() const {
+    return promoted_since_full_ >= std::max(MIN_FULL_THRESHOLD, old_after_full_ / 4);
+}
+
+void GcHeap::setMaxPause(std::chrono::microseconds budget) {
+    max_pause_ = budget;
+    if (budget.count() > 0) {
+        size_t threshold = static_cast<size_t>(budget.count()) * YOUNG_OBJECTS_PER_US;
+        young_threshold_ = std::clamp(threshold, MIN_YOUNG_THRESHOLD, YOUNG_THRESHOLD);
+    } else {
+        young_threshold_ = YOUNG_THRESHOLD;
+    }
+}
+
+void GcHeap::adaptYoungThreshold(size_t collected, std::chrono::steady_clock::duration pause) {
+    if (collected < MIN_YOUNG_THRESHOLD || pause.count() <= 0) return;
+
+    // Aim for half the budget, leaving the rest to the incremental cycle
+    double per_object = std::chrono::duration<double>(pause).count() / collected;
+    double target = std::chrono::duration<double>(max_pause_).count() / 2.0 / per_object;
+    size_t threshold = (young_threshold_ + static_cast<size_t>(std::min(target, 1e9))) / 2;
+    young_threshold_ = std::clamp(threshold, MIN_YOUNG_THRESHOLD, YOUNG_THRESHOLD);
+}
+
+void GcHeap::recordPause(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double, std::micro> pause = std::chrono::steady_clock::now() - start;
+    double pause_ms = pause.count() / 1000.0;
+    stats_.total_pause_ms += pause_ms;
+    stats_.max_pause_ms = std::max(stats_.max_pause_ms, pause_ms);
+    stats_.pauses_us.push_back(static_cast<float>(pause.count()));
+}
+
+size_t GcHeap::collectYoung() {
+    auto start = std::chrono::steady_clock::now();
+    size_t freed;
+    if (max_pause_.count() == 0) {
+        freed = fullCollectionDue() ? fullCollect() : collectGenerations(YOUNG);
+    } else {
+        size_t young = count_[YOUNG];
+        freed = collectGenerations(YOUNG);
+        adaptYoungThreshold(young, std::chrono::steady_clock::now() - start);
+
+        size_t growth = count_[OLD] > old_after_slice_ ? count_[OLD] - old_after_slice_ : 0;
+        size_t min_work = WORK_PER_OLD_GROWTH * growth;
+        if (!garbage_.empty()) {
+            clearGarbage(start + max_pause_, min_work);
+        } else {
+            if (phase_ == Phase::IDLE && fullCollectionDue()) startCycle();
+            if (phase_ != Phase::IDLE) freed += step(start + max_pause_, min_work);
+        }
+        old_after_slice_ = count_[OLD];
+    }
+    recordPause(start);
+    return freed;
+}
+
+size_t GcHeap::collect() {
+    auto start = std::chrono::steady_clock::now();
+    clearGarbage(std::chrono::steady_clock::time_point::max(), 0);
+    if (phase_ != Phase::IDLE) endCycle();
+    size_t freed = fullCollect();
+    recordPause(start);
+    return freed;
+}
+
+size_t GcHeap::fullCollect() {
+    size_t freed = collectGenerations(COLLECTING);
+    stats_.full_collections++;
+    old_after_full_ = count_[OLD];
+    promoted_since_full_ = 0;
+    return freed;
+}
+
+size_t GcHeap::collectGenerations(uint8_t oldest) {
+    if (collecting_) return 0;
+    collecting_ = true;
+
+    // Start from the strong count of every object being collected
+    for (uint8_t list = 0; list <= oldest; list++) {
+        for (GcObject* object = first_[list]; object; object = object->gc_next) {
+            object->gc_refs = strongCount(object);
+            object->gc_reachable = false;
+        }
+    }
+
+    // Subtract references between them; references from older objects stay
+    struct Subtract : GcVisitor {
+        uint8_t oldest;
+        explicit Subtract(uint8_t limit) : oldest(limit) {}
+        void visit(GcObject* object) override {
+            if (object->gc_generation <= oldest) object->gc_refs--;
+        }
+    } subtract(oldest);
+    for (uint8_t list = 0; list <= oldest; list++) {
+        for (GcObject* object = first_[list]; object; object = object->gc_next) {
+            object->traverse(subtract);
+        }
+    }
+
+    // Whatever is still referenced from outside is a root; mark from there
+    struct Mark : GcVisitor {
+        uint8_t oldest;
+        std::vector<GcObject*> pending;
+        explicit Mark(uint8_t limit) : oldest(limit) {}
+        void visit(GcObject* object) override {
+            if (object->gc_generation <= oldest && !object->gc_reachable) {
+                object->gc_reachable = true;
+                pending.push_back(object);
+            }
+        }
+    } mark(oldest);
+    for (uint8_t list = 0; list <= oldest; list++) {
+        for (GcObject* object = first_[list]; object; object = object->gc_next) {
+            if (object->gc_refs > 0) mark.visit(object);
+        }
+    }
+    while (!mark.pending.empty()) {
+        GcObject* object = mark.pending.back();
+        mark.pending.pop_back();
+        object->traverse(mark);
+    }
+
+    // Keep the garbage alive until every cycle is broken, then let it go
+    std::vector<Ref<GcObject>> garbage;
+    for (uint8_t list = 0; list <= oldest; list++) {
+        for (GcObject* object = first_[list]; object; object = object->gc_next) {
+            if (!object->gc_reachable) garbage.emplace_back(object);
+        }
+    }
+    for (auto& object : garbage) {
+        object->clearReferences();
+    }
+    size_t freed = garbage.size();
+    garbage.clear();
+
+    // Survivors of a young collection move to the old generation
+    size_t promoted = count_[YOUNG];
+    while (GcObject* object = first_[YOUNG]) {
+        first_[YOUNG] = object->gc_next;
+        count_[YOUNG]--;
+        link(object, OLD);
+    }
+    last_[YOUNG] = nullptr;
+    promoted_since_full_ += promoted;
+
+    stats_.collections++;
+    stats_.objects_freed += freed;
+    stats_.objects_promoted += promoted;
+
+    collecting_ = false;
+    return freed;
+}
+
+void GcHeap::startCycle() {
+    // Take the whole old list; COUNT relabels its objects as it goes
+    first_[COLLECTING] = first_[OLD];
+    last_[COLLECTING] = last_[OLD];
+    first_[OLD] = last_[OLD] = nullptr;
+
+    if (++epoch_ == 0) epoch_ = 1;
+    cursor_ = first_[COLLECTING];
+    phase_ = Phase::COUNT;
+    marking_ = true;
+}
+
+void GcHeap::endCycle() {
+    gray_.clear();
+    candidates_.clear();
+    cursor_ = nullptr;
+    phase_ = Phase::IDLE;
+    marking_ = false;
+
+    // Put the collected objects in front of the promotions made meanwhile;
+    // their labels stay COLLECTING, which is harmless while no cycle runs
+    if (!first_[COLLECTING]) return;
+    if (first_[OLD]) {
+        last_[COLLECTING]->gc_next = first_[OLD];
+        first_[OLD]->gc_prev = last_[COLLECTING];
+        last_[COLLECTING] = last_[OLD];
+    }
+    first_[OLD] = first_[COLLECTING];
+    last_[OLD] = last_[COLLECTING];
+    first_[COLLECTING] = last_[COLLECTING] = nullptr;
+}
+
+void GcHeap::mark(GcObject* object) {
+    if (object->gc_generation != COLLECTING || object->gc_mark == epoch_) return;
+    object->gc_mark = epoch_;
+
+    // Gray objects are kept alive so they cannot be freed before they are visited;
+    // objects owned by no Ref are live anyway and are not traversed
+    if (object->refCount() > 0) gray_.emplace_back(object);
+}
+
+void GcHeap::shade(GcObject* object) {
+    if (phase_ != Phase::IDLE) mark(object);
+}
+
+void GcHeap::shadeValue(const Value& value) {
+    struct Shade : GcVisitor {
+        GcHeap& heap;
+        explicit Shade(GcHeap& owner) : heap(owner) {}
+        void visit(GcObject* object) override { heap.shade(object); }
+    } shade(*this);
+    shade.visitValue(value);
+}
+
+void GcHeap::clearGarbage(std::chrono::steady_clock::time_point deadline, size_t min_work) {
+    // Objects are only freed once every one referencing them has been cleared
+    size_t work = 0;
+    while (!garbage_.empty()) {
+        garbage_.back()->clearReferences();
+        garbage_.pop_back();
+        if (++work % WORK_PER_CLOCK_CHECK == 0 && work >= min_work &&
+            std::chrono::steady_clock::now() >= deadline) {
+            return;
+        }
+    }
+}
+
+size_t GcHeap::step(std::chrono::steady_clock::time_point deadline, size_t min_work) {
+    size_t work = 0;
+    auto expired = [&work, deadline, min_work] {
+        return ++work % WORK_PER_CLOCK_CHECK == 0 && work >= min_work &&
+               std::chrono::steady_clock::now() >= deadline;
+    };
+
+    if (phase_ == Phase::COUNT) {
+        while (GcObject* object = cursor_) {
+            cursor_ = object->gc_next;
+            object->gc_generation = COLLECTING;
+            object->gc_refs = strongCount(object);
+            if (expired()) return 0;
+        }
+        phase_ = Phase::SUBTRACT;
+        cursor_ = first_[COLLECTING];
+    }
+
+    if (phase_ == Phase::SUBTRACT) {
+        struct Subtract : GcVisitor {
+            void visit(GcObject* object) override {
+                if (object->gc_generation == COLLECTING) object->gc_refs--;
+            }
+        } subtract;
+        while (GcObject* object = cursor_) {
+            cursor_ = object->gc_next;
+            object->traverse(subtract);
+            if (expired()) return 0;
+        }
+        phase_ = Phase::ROOTS;
+        cursor_ = first_[COLLECTING];
+    }
+
+    if (phase_ == Phase::ROOTS) {
+        while (GcObject* object = cursor_) {
+            cursor_ = object->gc_next;
+            if (object->gc_refs > 0) mark(object);
+            if (expired()) return 0;
+        }
+        phase_ = Phase::MARK;
+    }
+
+    struct Mark : GcVisitor {
+        GcHeap& heap;
+        explicit Mark(GcHeap& owner) : heap(owner) {}
+        void visit(GcObject* object) override { heap.mark(object); }
+    } marker(*this);
+    while (!gray_.empty()) {
+        Ref<GcObject> object = std::move(gray_.back());
+        gray_.pop_back();
+        object->traverse(marker);
+        object.reset();
+        if (expired()) return 0;
+    }
+    if (phase_ == Phase::MARK) {
+        phase_ = Phase::SWEEP;
+        cursor_ = first_[COLLECTING];
+    }
+
+    // Objects marked from here on by the write barrier simply drop out
+    while (GcObject* object = cursor_) {
+        cursor_ = object->gc_next;
+        if (object->gc_mark != epoch_) {
+            if (object->refCount() > 0) {
+                candidates_.emplace_back(object);
+            } else {
+                object->gc_mark = epoch_;
+            }
+        }
+        if (expired()) return 0;
+    }
+
+    return finishCycle();
+}
+
+size_t GcHeap::finishCycle() {
+    collecting_ = true;
+    marking_ = false;
+
+    // The counts above went stale while the program ran. Re-run trial
+    // deletion among the unmarked objects alone, which is exact for them.
+    std::vector<Ref<GcObject>> candidates;
+    for (auto& object : candidates_) {
+        if (object->gc_mark != epoch_) candidates.push_back(std::move(object));
+    }
+    candidates_.clear();
+
+    for (auto& object : candidates) {
+        object->gc_refs = strongCount(object.get()) - 1;  // Minus our own reference
+    }
+    struct Subtract : GcVisitor {
+        uint32_t epoch;
+        explicit Subtract(uint32_t current) : epoch(current) {}
+        void visit(GcObject* object) override {
+            if (object->gc_generation == COLLECTING && object->gc_mark != epoch) object->gc_refs--;
+        }
+    } subtract(epoch_);
+    for (auto& object : candidates) {
+        object->traverse(subtract);
+    }
+
+    // Candidates still referenced from elsewhere are live after all
+    struct Rescue : GcVisitor {
+        uint32_t epoch;
+        std::vector<GcObject*> pending;
+        explicit Rescue(uint32_t current) : epoch(current) {}
+        void visit(GcObject* object) override {
+            if (object->gc_generation == COLLECTING && object->gc_mark != epoch) {
+                object->gc_mark = epoch;
+                pending.push_back(object);
+            }
+        }
+    } rescue(epoch_);
+    for (auto& object : candidates) {
+        if (object->gc_refs > 0) rescue.visit(object.get());
+    }
+    while (!rescue.pending.empty()) {
+        GcObject* object = rescue.pending.back();
+        rescue.pending.pop_back();
+        object->traverse(rescue);
+    }
+
+    // The program cannot reach the garbage, so clearing it can wait for later slices
+    for (auto& object : candidates) {
+        if (object->gc_mark != epoch_) garbage_.push_back(std::move(object));
+    }
+    candidates.clear();
+    size_t freed = garbage_.size();
+
+    endCycle();
+    stats_.collections++;
+    stats_.full_collections++;
+    stats_.objects_freed += freed;
+    old_after_full_ = count_[OLD];
+    promoted_since_full_ = 0;
+
+    collecting_ = false;
+    return freed;
+}
+
+void GcHeap::printStats(std::ostream& out) const {
+    out << "GC: " << stats_.collections << " collections (" << stats_.full_collections
+        << " full), " << stats_.objects_freed << " objects freed, "
+        << stats_.objects_promoted << " promoted, " << trackedCount() << " objects live\n";
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3)
+        << "GC pauses: total " << stats_.total_pause_ms << " ms, max "
+        << stats_.max_pause_ms << " ms, p50 " << stats_.pausePercentile(50) / 1000.0
+        << " ms, p99 " << stats_.pausePercentile(99) / 1000.0 << " ms\n";
+    out.flags(flags);
+    out.precision(precision);
+    if constexpr (COUNT_REFCOUNT_OPERATIONS) {
+        out << "Refcounts: " << RefCountStats::increments << " increments, "
+            << RefCountStats::decrements << " decrements\n";
+    }
+}
+
+} // namespace caesar
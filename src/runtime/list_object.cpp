@@ -0,0 +1,155 @@
+/**
+ * @file list_object.cpp
+ * @brief Runtime list implementation
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/list_object.h"
+#include <string>
+
+namespace caesar {
+
+size_t ListObject::size() const {
+    switch (storage_) {
+        case Storage::INT: return ints_.size();
+        case Storage::FLOAT: return floats_.size();
+        case Storage::GENERIC: return values_.size();
+        case Storage::EMPTY: break;
+    }
+    return 0;
+}
+
+size_t ListObject::normalizeIndex(int64_t index) const {
+    int64_t length = static_cast<int64_t>(size());
+    if (index < 0) {
+        index += length;
+    }
+    if (index < 0 || index >= length) {
+        throw RuntimeError("list index out of range");
+    }
+    return static_cast<size_t>(index);
+}
+
+Value ListObject::get(size_t index) const {
+    switch (storage_) {
+        case Storage::INT: return ints_[index];
+        case Storage::FLOAT: return floats_[index];
+        case Storage::GENERIC: return values_[index];
+        case Storage::EMPTY: break;
+    }
+    throw RuntimeError("list index out of range");
+}
+
+void ListObject::set(size_t index, const Value& value) {
+    if (!fits(value)) {
+        promoteToGeneric();
+    }
+
+    switch (storage_) {
+        case Storage::INT: ints_[index] = std::get<int64_t>(value); break;
+        case Storage::FLOAT: floats_[index] = std::get<double>(value); break;
+        case Storage::GENERIC:
+            GcHeap::writeBarrier(value);
+            values_[index] = value;
+            break;
+        case Storage::EMPTY: throw RuntimeError("list assignment index out of range");
+    }
+}
+
+void ListObject::append(const Value& value) {
+    if (storage_ == Storage::EMPTY) {
+        adoptStrategyFor(value);
+    } else if (!fits(value)) {
+        promoteToGeneric();
+    }
+
+    switch (storage_) {
+        case Storage::INT: ints_.push_back(std::get<int64_t>(value)); break;
+        case Storage::FLOAT: floats_.push_back(std::get<double>(value)); break;
+        case Storage::GENERIC:
+            GcHeap::writeBarrier(value);
+            values_.push_back(value);
+            break;
+        case Storage::EMPTY: break;
+    }
+}
+
+void ListObject::reserve(size_t capacity) {
+    switch (storage_) {
+        case Storage::INT: ints_.reserve(capacity); break;
+        case Storage::FLOAT: floats_.reserve(capacity); break;
+        case Storage::GENERIC: values_.reserve(capacity); break;
+        case Storage::EMPTY: break;
+    }
+}
+
+Value ListObject::pop(size_t index) {
+    Value result = get(index);
+
+    switch (storage_) {
+        case Storage::INT: ints_.erase(ints_.begin() + index); break;
+        case Storage::FLOAT: floats_.erase(floats_.begin() + index); break;
+        case Storage::GENERIC: values_.erase(values_.begin() + index); break;
+        case Storage::EMPTY: break;
+    }
+
+    // An emptied list may pick a new unboxed strategy on its next insert
+    if (size() == 0) {
+        storage_ = Storage::EMPTY;
+        ints_.clear();
+        floats_.clear();
+        values_.clear();
+    }
+    return result;
+}
+
+bool ListObject::fits(const Value& value) const {
+    switch (storage_) {
+        case Storage::INT: return std::holds_alternative<int64_t>(value);
+        case Storage::FLOAT: return std::holds_alternative<double>(value);
+        case Storage::GENERIC: return true;
+        case Storage::EMPTY: return false;
+    }
+    return false;
+}
+
+void ListObject::adoptStrategyFor(const Value& value) {
+    if (std::holds_alternative<int64_t>(value)) {
+        storage_ = Storage::INT;
+    } else if (std::holds_alternative<double>(value)) {
+        storage_ = Storage::FLOAT;
+    } else {
+        storage_ = Storage::GENERIC;
+    }
+}
+
+void ListObject::promoteToGeneric() {
+    if (storage_ == Storage::GENERIC) return;
+
+    values_.reserve(size() + 1);
+    if (storage_ == Storage::INT) {
+        for (int64_t v : ints_) values_.emplace_back(v);
+        std::vector<int64_t>().swap(ints_);
+    } else if (storage_ == Storage::FLOAT) {
+        for (double v : floats_) values_.emplace_back(v);
+        std::vector<double>().swap(floats_);
+    }
+    storage_ = Storage::GENERIC;
+}
+
+void ListObject::traverse(GcVisitor& visitor) const {
+    // Unboxed strategies hold no references
+    for (const Value& value : values_) {
+        visitor.visitValue(value);
+    }
+}
+
+void ListObject::clearReferences() {
+    ints_.clear();
+    floats_.clear();
+    values_.clear();
+    storage_ = Storage::EMPTY;
+}
+
+} // namespace caesar
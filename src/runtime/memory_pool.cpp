@@ -0,0 +1,68 @@
+/**
+ * @file memory_pool.cpp
+ * @brief Size-class pool allocator for runtime objects
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/memory_pool.h"
+#include <iomanip>
+#include <ostream>
+
+namespace caesar {
+
+MemoryPool& MemoryPool::instance() {
+    static MemoryPool* pool = new MemoryPool();
+    return *pool;
+}
+
+void* MemoryPool::refill(SizeClass& size_class, size_t block_size) {
+    if (size_class.bump + block_size > size_class.bump_end) {
+        // The tail of the old slab, if any, is too small for a block and stays unused
+        char* slab = static_cast<char*>(::operator new(SLAB_SIZE));
+        slabs_.push_back(slab);
+        size_class.bump = slab;
+        size_class.bump_end = slab + SLAB_SIZE;
+    }
+    void* block = size_class.bump;
+    size_class.bump += block_size;
+    return block;
+}
+
+void* MemoryPool::allocateLarge(size_t size) {
+    large_stats_.allocations++;
+    large_live_bytes_ += size;
+    return ::operator new(size);
+}
+
+void MemoryPool::deallocateLarge(void* memory, size_t size) {
+    large_stats_.frees++;
+    large_live_bytes_ -= size;
+    ::operator delete(memory);
+}
+
+size_t MemoryPool::liveBytes() const {
+    size_t bytes = large_live_bytes_;
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        bytes += classes_[i].stats.liveBlocks() * (i + 1) * GRANULE;
+    }
+    return bytes;
+}
+
+void MemoryPool::printStats(std::ostream& out) const {
+    out << "Memory: " << liveBytes() << " bytes live, " << slabBytes() << " bytes in "
+        << slabs_.size() << " slabs, " << large_live_bytes_ << " bytes in large blocks\n";
+    out << "  size   allocations          live\n";
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        const MemoryClassStats& stats = classes_[i].stats;
+        if (stats.allocations == 0) continue;
+        out << std::setw(6) << (i + 1) * GRANULE << std::setw(14) << stats.allocations
+            << std::setw(14) << stats.liveBlocks() << "\n";
+    }
+    if (large_stats_.allocations > 0) {
+        out << "  >" << MAX_SMALL_SIZE << std::setw(13) << large_stats_.allocations
+            << std::setw(14) << large_stats_.liveBlocks() << "\n";
+    }
+}
+
+} // namespace caesar
@@ -0,0 +1,143 @@
+/**
+ * @file string_object.cpp
+ * @brief Reference-counted runtime string implementation
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "caesar/string_object.h"
+#include "caesar/memory_pool.h"
+#include <cstring>
+#include <new>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+namespace caesar {
+
+namespace {
+
+/// Smallest capacity allocated for a buffer that is being appended to
+constexpr size_t MIN_APPEND_CAPACITY = 32;
+
+} // anonymous namespace
+
+// StringBuffer implementation
+StringBuffer* StringBuffer::create(size_t capacity) {
+    void* memory = MemoryPool::instance().allocate(offsetof(StringBuffer, data) + capacity + 1);
+    StringBuffer* buffer = static_cast<StringBuffer*>(memory);
+    buffer->refcount = 0;
+    buffer->used = 0;
+    buffer->capacity = capacity;
+    buffer->data[0] = '\0';
+    return buffer;
+}
+
+void StringBuffer::destroy(StringBuffer* buffer) {
+    MemoryPool::instance().deallocate(buffer, offsetof(StringBuffer, data) + buffer->capacity + 1);
+}
+
+// StringObject implementation
+StringObject* StringObject::create(StringBuffer* buffer, size_t length) {
+    ++buffer->refcount;
+    void* memory = MemoryPool::instance().allocate(sizeof(StringObject));
+    return new (memory) StringObject{0, false, length, 0, buffer};
+}
+
+void StringObject::destroy(StringObject* object) {
+    StringBuffer::release(object->buffer);
+    MemoryPool::instance().deallocate(object, sizeof(StringObject));
+}
+
+StringObject* StringObject::empty() {
+    // Never released: the static holds one reference for the lifetime of the program
+    static StringObject* empty_object = [] {
+        StringObject* object = create(StringBuffer::create(0), 0);
+        object->refcount = 1;
+        object->interned = true;
+        return object;
+    }();
+    return empty_object;
+}
+
+// String implementation
+String::String() : object_(StringObject::empty()) {
+    ++object_->refcount;
+}
+
+String::String(std::string_view text) {
+    if (text.empty()) {
+        object_ = StringObject::empty();
+    } else {
+        StringBuffer* buffer = StringBuffer::create(text.size());
+        std::memcpy(buffer->data, text.data(), text.size());
+        buffer->used = text.size();
+        object_ = StringObject::create(buffer, text.size());
+    }
+    ++object_->refcount;
+}
+
+size_t String::computeHash() const {
+    size_t h = std::hash<std::string_view>()(view());
+    // 0 marks "not computed yet"
+    object_->hash = h ? h : 1;
+    return object_->hash;
+}
+
+String String::intern(std::string_view text) {
+    // Keys view the characters of their own immortal interned object
+    static std::unordered_map<std::string_view, StringObject*> table;
+
+    auto it = table.find(text);
+    if (it == table.end()) {
+        String canonical(text);
+        canonical.object_->interned = true;
+        ++canonical.object_->refcount;  // Reference held by the table
+        it = table.emplace(canonical.view(), canonical.object_).first;
+    }
+
+    ++it->second->refcount;
+    return String(it->second);
+}
+
+String& String::operator=(const String& other) {
+    ++other.object_->refcount;
+    StringObject::release(object_);
+    object_ = other.object_;
+    return *this;
+}
+
+String& String::operator=(String&& other) noexcept {
+    std::swap(object_, other.object_);
+    return *this;
+}
+
+String String::concat(const String& left, const String& right) {
+    if (right.empty()) return left;
+    if (left.empty()) return right;
+
+    size_t length = left.size() + right.size();
+    StringBuffer* buffer = left.object_->buffer;
+
+    // Only the string covering the buffer's whole used prefix may extend it;
+    // anything shorter would overwrite characters another string can see
+    if (buffer->used != left.size() || buffer->capacity < length) {
+        size_t capacity = length + length / 2;
+        if (capacity < MIN_APPEND_CAPACITY) capacity = MIN_APPEND_CAPACITY;
+        StringBuffer* grown = StringBuffer::create(capacity);
+        std::memcpy(grown->data, left.data(), left.size());
+        grown->used = left.size();
+        buffer = grown;
+    }
+
+    // right may view the same buffer, but always below buffer->used
+    std::memcpy(buffer->data + buffer->used, right.data(), right.size());
+    buffer->used = length;
+    buffer->data[length] = '\0';
+
+    StringObject* object = StringObject::create(buffer, length);
+    ++object->refcount;
+    return String(object);
+}
+
+} // namespace caesar
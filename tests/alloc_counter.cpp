@@ -0,0 +1,68 @@
+/**
+ * @file alloc_counter.cpp
+ * @brief Counting replacements of the global operator new and delete
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "alloc_counter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+caesar::alloc_counter::Counts counts;
+
+/// Each block starts with its requested size, padded to keep the payload aligned
+constexpr size_t HEADER = alignof(std::max_align_t);
+
+void* countedAllocate(size_t size) {
+    void* block = std::malloc(size + HEADER);
+    if (!block) return nullptr;
+    *static_cast<size_t*>(block) = size;
+
+    counts.allocations++;
+    counts.bytes_allocated += size;
+    counts.live_bytes += static_cast<int64_t>(size);
+    if (counts.live_bytes > counts.peak_live_bytes) counts.peak_live_bytes = counts.live_bytes;
+    return static_cast<char*>(block) + HEADER;
+}
+
+void countedFree(void* pointer) {
+    if (!pointer) return;
+    void* block = static_cast<char*>(pointer) - HEADER;
+    counts.live_bytes -= static_cast<int64_t>(*static_cast<size_t*>(block));
+    std::free(block);
+}
+
+} // anonymous namespace
+
+namespace caesar {
+namespace alloc_counter {
+
+Counts current() { return counts; }
+
+void resetPeak() { counts.peak_live_bytes = counts.live_bytes; }
+
+} // namespace alloc_counter
+} // namespace caesar
+
+void* operator new(size_t size) {
+    if (void* pointer = countedAllocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* pointer = countedAllocate(size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { countedFree(pointer); }
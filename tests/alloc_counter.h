@@ -0,0 +1,53 @@
+/**
+ * @file alloc_counter.h
+ * @brief Counts heap allocations made through operator new
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ *
+ * Linking alloc_counter.cpp into a program replaces the global operator
+ * new and delete with versions that count calls and bytes. The counters
+ * are plain integers: only count single-threaded phases.
+ */
+
+#ifndef CAESAR_ALLOC_COUNTER_H
+#define CAESAR_ALLOC_COUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace caesar {
+namespace alloc_counter {
+
+struct Counts {
+    uint64_t allocations = 0;     ///< Calls to operator new
+    uint64_t bytes_allocated = 0; ///< Bytes requested from operator new
+    int64_t live_bytes = 0;       ///< Requested bytes not yet deleted
+    int64_t peak_live_bytes = 0;  ///< Highest live_bytes since resetPeak()
+};
+
+/**
+ * @brief Counts since the program started
+ */
+Counts current();
+
+/**
+ * @brief Start tracking peak_live_bytes from the current live bytes
+ */
+void resetPeak();
+
+/**
+ * @brief Counts between two snapshots; live_bytes is the growth
+ */
+inline Counts since(const Counts& before, const Counts& after) {
+    Counts delta;
+    delta.allocations = after.allocations - before.allocations;
+    delta.bytes_allocated = after.bytes_allocated - before.bytes_allocated;
+    delta.live_bytes = after.live_bytes - before.live_bytes;
+    delta.peak_live_bytes = after.peak_live_bytes - before.live_bytes;
+    return delta;
+}
+
+} // namespace alloc_counter
+} // namespace caesar
+
+#endif // CAESAR_ALLOC_COUNTER_H
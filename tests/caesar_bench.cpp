@@ -0,0 +1,979 @@
+/**
+ * @file caesar_bench.cpp
+ * @brief Runs the comparison suite in tests/comparison and reports timing statistics
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ *
+ * Usage: caesar_bench [options] [benchmark...]
+ *
+ *   --runs=<n>       Timed runs per benchmark and language (default 10)
+ *   --warmup=<n>     Untimed runs before the timed ones (default 1)
+ *   --json=<file>    Also write the results, including every sample, as JSON
+ *   --caesar-only    Skip the C++ and Python versions
+ *   --no-micro       Skip the lexer, parser and interpreter microbenchmarks
+ *   --dir=<path>     Comparison suite directory (default: the source tree's)
+ *   --baseline=<file>
+ *                    Compare the Caesar results with an earlier --json file
+ *   --threshold=<percent>
+ *                    Median slowdown reported as a regression (default 5)
+ *   --alpha=<p>      Significance level of the regression test (default 0.05)
+ *   --counters       Also count CPU events with perf_event_open, where allowed
+ *   --memory         Also measure the memory of each phase of each Caesar program
+ *
+ * Each caesar/<name>.csr is lexed, parsed and interpreted in-process, with
+ * a fresh Interpreter per run and its output discarded. The matching
+ * cpp/<name> binary (built by CMake) and python/<name>.py script are run as
+ * child processes with the scale the Caesar program uses, when available.
+ * For each language the harness prints min, median, p95 and standard
+ * deviation of the wall time, and the peak resident set size.
+ *
+ * The microbenchmarks time the lexer and the parser on the suite's Caesar
+ * sources, and the interpreter alone on a small mixed program.
+ *
+ * With --baseline, the samples of each Caesar benchmark are compared with
+ * the baseline's by a one-sided Mann-Whitney U test. A benchmark regressed
+ * if its median grew by more than the threshold and the test rejects "not
+ * slower" at the significance level. The exit status is then 2.
+ *
+ * With --counters, cycles, instructions, branch misses and L1D, LLC and
+ * dTLB read misses are counted over the timed runs, including those of the
+ * child processes, and reported as IPC and misses per 1000 instructions.
+ * Without access to the counters, as in most containers, the harness says
+ * so and reports timings only.
+ *
+ * With --memory, each Caesar program is run once more with its lexing,
+ * parsing and interpreting measured apart: peak RSS, and from the counting
+ * operator new in alloc_counter the allocations, bytes allocated, peak
+ * live bytes and the bytes still live when the phase is over. The shim is
+ * always linked in, so timings include its small per-allocation cost.
+ */
+
+#include "caesar/lexer.h"
+#include "caesar/parser.h"
+#include "caesar/interpreter.h"
+#include "alloc_counter.h"
+#include "perf_counters.h"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef CAESAR_COMPARISON_DIR
+#define CAESAR_COMPARISON_DIR "tests/comparison"
+#endif
+#ifndef CAESAR_COMPARISON_CPP_DIR
+#define CAESAR_COMPARISON_CPP_DIR "comparison/cpp"
+#endif
+
+namespace {
+
+/// Marks the line of each Caesar program that sets its problem size
+const char* const SCALE_MARKER = "# Can be modified for different test scales";
+
+/// Copies of the suite's sources lexed or parsed per microbenchmark run
+constexpr int FRONT_END_REPEAT = 50;
+
+/// Interpreted by the interpreter microbenchmark; mixes the common node types
+const char* const INTERPRETER_PROGRAM = R"(
+def add(a, b):
+    return a + b
+
+def run(n):
+    total = 0
+    items = []
+    table = {}
+    text = ""
+    for i in range(n):
+        total = add(total, i * 2 - 1)
+        items.append(i)
+        table[i % 64] = total
+        if i % 8 == 0:
+            text = text + "x"
+    return total + len(items) + len(table) + len(text)
+
+result = run(20000)
+)";
+
+struct Options {
+    int runs = 10;
+    int warmup = 1;
+    std::string json_output;
+    bool caesar_only = false;
+    bool micro = true;
+    std::string baseline;
+    double threshold_percent = 5;
+    double alpha = 0.05;
+    bool counters = false;
+    bool memory = false;
+    caesar::PerfCounters* perf_counters = nullptr;  ///< Set when --counters could open some
+    std::string directory = CAESAR_COMPARISON_DIR;
+    std::string cpp_directory = CAESAR_COMPARISON_CPP_DIR;
+    std::vector<std::string> filters;
+};
+
+/**
+ * @brief Memory used by one phase of running a Caesar program
+ */
+struct PhaseMemory {
+    const char* phase;
+    caesar::alloc_counter::Counts counts;  ///< live_bytes is what the phase left allocated
+    long peak_rss_kb;
+};
+
+/**
+ * @brief Samples of one benchmark in one language
+ */
+struct Result {
+    std::string language;
+    std::vector<double> samples_ms;
+    long peak_rss_kb = 0;
+    std::string error;  ///< Set when a run failed; samples are then incomplete
+    bool counted = false;
+    caesar::PerfCounters::Counts counts_per_run{};  ///< When counted
+    std::vector<PhaseMemory> memory;                ///< With --memory, Caesar only
+
+    double min() const { return *std::min_element(samples_ms.begin(), samples_ms.end()); }
+
+    /// Nearest-rank percentile
+    double percentile(double p) const {
+        std::vector<double> sorted = samples_ms;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+        return sorted[rank == 0 ? 0 : rank - 1];
+    }
+
+    double median() const {
+        std::vector<double> sorted = samples_ms;
+        std::sort(sorted.begin(), sorted.end());
+        size_t middle = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+    }
+
+    double mean() const {
+        double sum = 0;
+        for (double sample : samples_ms) sum += sample;
+        return sum / samples_ms.size();
+    }
+
+    /// Sample standard deviation
+    double stddev() const {
+        if (samples_ms.size() < 2) return 0;
+        double average = mean();
+        double squares = 0;
+        for (double sample : samples_ms) squares += (sample - average) * (sample - average);
+        return std::sqrt(squares / (samples_ms.size() - 1));
+    }
+};
+
+struct Benchmark {
+    std::string name;
+    long long scale = 0;
+    std::vector<Result> results;
+};
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+/**
+ * @brief The problem size set on the marked line of a Caesar program, or 0
+ */
+long long findScale(const std::string& source) {
+    size_t marker = source.find(SCALE_MARKER);
+    if (marker == std::string::npos) return 0;
+    size_t line_start = source.rfind('\n', marker);
+    size_t equals = source.find('=', line_start == std::string::npos ? 0 : line_start);
+    if (equals == std::string::npos || equals > marker) return 0;
+    return std::strtoll(source.c_str() + equals + 1, nullptr, 10);
+}
+
+/**
+ * @brief Reset the peak RSS of this process, so the next read covers one benchmark
+ *
+ * Linux only; elsewhere the peak covers the whole harness run.
+ */
+void resetPeakRss() {
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0) return;
+    ssize_t written = write(fd, "5", 1);
+    (void)written;
+    close(fd);
+}
+
+long peakRssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) return std::strtol(line.c_str() + 6, nullptr, 10);
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Interpret a program with a fresh Interpreter, discarding its output
+ */
+void interpretQuietly(caesar::Program* program) {
+    std::ostringstream discarded;
+    std::streambuf* stdout_buffer = std::cout.rdbuf(discarded.rdbuf());
+    try {
+        caesar::Interpreter interpreter;
+        interpreter.interpret(program);
+    } catch (...) {
+        std::cout.rdbuf(stdout_buffer);
+        throw;
+    }
+    std::cout.rdbuf(stdout_buffer);
+}
+
+/**
+ * @brief Run a Caesar program the way `caesar --interpret` does
+ */
+void interpretOnce(const std::string& source) {
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    interpretQuietly(program.get());
+}
+
+/**
+ * @brief Measure the memory of lexing, parsing and interpreting source once
+ *
+ * Tokens and AST stay alive until the end, so their live bytes are what
+ * the interpreter runs alongside. Runtime objects come from MemoryPool
+ * slabs, which are counted when a slab is allocated and never returned.
+ */
+std::vector<PhaseMemory> measurePhases(const std::string& source) {
+    namespace counter = caesar::alloc_counter;
+    std::vector<PhaseMemory> phases;
+
+    auto measure = [&](const char* phase, auto&& run) {
+        resetPeakRss();
+        counter::resetPeak();
+        counter::Counts before = counter::current();
+        run();
+        phases.push_back({phase, counter::since(before, counter::current()), peakRssKb()});
+    };
+
+    std::vector<caesar::Token> tokens;
+    std::unique_ptr<caesar::Program> program;
+    measure("lex", [&] { tokens = caesar::Lexer(source).tokenize(); });
+    measure("parse", [&] { program = caesar::Parser(tokens).parse(); });
+    measure("interpret", [&] { interpretQuietly(program.get()); });
+    return phases;
+}
+
+/**
+ * @brief Times one run, and counts its CPU events when --counters is on
+ */
+class Stopwatch {
+    caesar::PerfCounters* counters_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    explicit Stopwatch(const Options& options) : counters_(options.perf_counters) {}
+
+    void start() {
+        if (counters_) counters_->start();
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    /// Milliseconds since start()
+    double stop() {
+        auto end = std::chrono::steady_clock::now();
+        if (counters_) counters_->stop();
+        return std::chrono::duration<double, std::milli>(end - start_).count();
+    }
+};
+
+/**
+ * @brief Average the counts of the timed runs into result
+ */
+void takeCounts(const Options& options, Result& result) {
+    if (!options.perf_counters || result.samples_ms.empty()) return;
+    result.counted = true;
+    for (int event = 0; event < caesar::PerfCounters::EVENT_COUNT; event++) {
+        result.counts_per_run[event] = options.perf_counters->totals()[event] / result.samples_ms.size();
+    }
+}
+
+/**
+ * @brief Warm up and time an in-process benchmark
+ *
+ * @param run Runs the benchmark once and returns the milliseconds to count
+ */
+template <typename Run>
+Result timeInProcess(const Options& options, Run run) {
+    Result result;
+    result.language = "caesar";
+    resetPeakRss();
+    try {
+        for (int i = 0; i < options.warmup; i++) run();
+        if (options.perf_counters) options.perf_counters->clearTotals();
+        for (int i = 0; i < options.runs; i++) result.samples_ms.push_back(run());
+        takeCounts(options, result);
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    result.peak_rss_kb = peakRssKb();
+    return result;
+}
+
+Result runCaesar(const std::string& source, const Options& options) {
+    return timeInProcess(options, [&] {
+        Stopwatch stopwatch(options);
+        stopwatch.start();
+        interpretOnce(source);
+        return stopwatch.stop();
+    });
+}
+
+/**
+ * @brief Time Lexer::tokenize on copies of the suite's sources
+ */
+Result runLexerMicro(const std::string& corpus, const Options& options) {
+    return timeInProcess(options, [&] {
+        Stopwatch stopwatch(options);
+        stopwatch.start();
+        caesar::Lexer lexer(corpus);
+        size_t tokens = lexer.tokenize().size();
+        double elapsed_ms = stopwatch.stop();
+        if (tokens == 0) throw std::runtime_error("empty corpus");
+        return elapsed_ms;
+    });
+}
+
+/**
+ * @brief Time Parser::parse on the tokens of copies of the suite's sources
+ */
+Result runParserMicro(const std::string& corpus, const Options& options) {
+    caesar::Lexer lexer(corpus);
+    std::vector<caesar::Token> tokens = lexer.tokenize();
+    return timeInProcess(options, [&] {
+        std::vector<caesar::Token> copy = tokens;
+        Stopwatch stopwatch(options);
+        stopwatch.start();
+        caesar::Parser parser(std::move(copy));
+        auto program = parser.parse();
+        return stopwatch.stop();
+    });
+}
+
+/**
+ * @brief Time the interpreter alone on INTERPRETER_PROGRAM
+ */
+Result runInterpreterMicro(const Options& options) {
+    return timeInProcess(options, [&] {
+        caesar::Lexer lexer(INTERPRETER_PROGRAM);
+        caesar::Parser parser(lexer.tokenize());
+        auto program = parser.parse();
+        Stopwatch stopwatch(options);
+        stopwatch.start();
+        caesar::Interpreter interpreter;
+        interpreter.interpret(program.get());
+        return stopwatch.stop();
+    });
+}
+
+/**
+ * @brief Run a program to completion with its output discarded
+ *
+ * @return The exit status, or 127 if it could not be started
+ */
+int runProcess(const std::vector<std::string>& command, const Options& options, double& elapsed_ms,
+               long& peak_rss_kb) {
+    std::vector<char*> argv;
+    for (const std::string& argument : command) argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+
+    // The child inherits the counters, and adds its counts to them when it exits
+    Stopwatch stopwatch(options);
+    stopwatch.start();
+    pid_t pid = fork();
+    if (pid < 0) {
+        stopwatch.stop();
+        return 127;
+    }
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+        }
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    bool reaped = wait4(pid, &status, 0, &usage) >= 0;
+    elapsed_ms = stopwatch.stop();
+    if (!reaped) return 127;
+    peak_rss_kb = std::max(peak_rss_kb, static_cast<long>(usage.ru_maxrss));
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+/**
+ * @brief Time an external implementation; returns false if it is not available
+ */
+bool runExternal(const std::string& language, const std::vector<std::string>& command,
+                 const Options& options, Result& result) {
+    result.language = language;
+    for (int i = 0; i < options.warmup + options.runs; i++) {
+        if (i == options.warmup && options.perf_counters) options.perf_counters->clearTotals();
+        double elapsed_ms = 0;
+        int status = runProcess(command, options, elapsed_ms, result.peak_rss_kb);
+        if (status == 127 && i == 0) return false;
+        if (status != 0) {
+            result.error = command[0] + " exited with status " + std::to_string(status);
+            return true;
+        }
+        if (i >= options.warmup) result.samples_ms.push_back(elapsed_ms);
+    }
+    takeCounts(options, result);
+    return true;
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(18) << "benchmark" << std::setw(8) << "lang"
+              << std::right << std::setw(11) << "min ms" << std::setw(11) << "median ms"
+              << std::setw(11) << "p95 ms" << std::setw(11) << "stddev ms"
+              << std::setw(13) << "peak RSS KB" << "\n";
+}
+
+void printResult(const std::string& name, const Result& result) {
+    std::cout << std::left << std::setw(18) << name << std::setw(8) << result.language;
+    if (!result.error.empty()) {
+        std::cout << "failed: " << result.error << "\n";
+        return;
+    }
+    std::cout << std::right << std::fixed << std::setprecision(2) << std::setw(11) << result.min()
+              << std::setw(11) << result.median() << std::setw(11) << result.percentile(95)
+              << std::setw(11) << result.stddev() << std::setw(13) << result.peak_rss_kb << "\n";
+}
+
+/**
+ * @brief Print IPC and misses per 1000 instructions of each counted result
+ */
+void printCounters(const std::vector<Benchmark>& benchmarks, const caesar::PerfCounters& counters) {
+    using caesar::PerfCounters;
+
+    std::cout << "\n" << std::left << std::setw(18) << "benchmark" << std::setw(8) << "lang"
+              << std::right << std::setw(8) << "IPC" << std::setw(14) << "br-miss/1K"
+              << std::setw(12) << "L1D/1K" << std::setw(12) << "LLC/1K" << std::setw(12)
+              << "dTLB/1K" << "\n";
+    for (const Benchmark& benchmark : benchmarks) {
+        for (const Result& result : benchmark.results) {
+            if (!result.counted) continue;
+            const PerfCounters::Counts& counts = result.counts_per_run;
+            double instructions = counts[PerfCounters::INSTRUCTIONS];
+            bool per_instruction = counters.available(PerfCounters::INSTRUCTIONS) && instructions > 0;
+
+            std::cout << std::left << std::setw(18) << benchmark.name << std::setw(8)
+                      << result.language << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(8);
+            if (per_instruction && counters.available(PerfCounters::CYCLES) &&
+                counts[PerfCounters::CYCLES] > 0) {
+                std::cout << instructions / counts[PerfCounters::CYCLES];
+            } else {
+                std::cout << "-";
+            }
+
+            const PerfCounters::Event misses[] = {PerfCounters::BRANCH_MISSES, PerfCounters::L1D_MISSES,
+                                                  PerfCounters::LLC_MISSES, PerfCounters::DTLB_MISSES};
+            for (PerfCounters::Event event : misses) {
+                std::cout << std::setw(event == PerfCounters::BRANCH_MISSES ? 14 : 12);
+                if (per_instruction && counters.available(event)) {
+                    std::cout << counts[event] * 1000 / instructions;
+                } else {
+                    std::cout << "-";
+                }
+            }
+            std::cout << "\n";
+        }
+    }
+}
+
+void printMemory(const std::vector<Benchmark>& benchmarks) {
+    std::cout << "\n" << std::left << std::setw(18) << "benchmark" << std::setw(11) << "phase"
+              << std::right << std::setw(12) << "allocs" << std::setw(13) << "allocated KB"
+              << std::setw(13) << "peak live KB" << std::setw(10) << "left KB" << std::setw(13)
+              << "peak RSS KB" << "\n";
+    for (const Benchmark& benchmark : benchmarks) {
+        for (const PhaseMemory& phase : benchmark.results.front().memory) {
+            std::cout << std::left << std::setw(18) << benchmark.name << std::setw(11) << phase.phase
+                      << std::right << std::setw(12) << phase.counts.allocations << std::setw(13)
+                      << phase.counts.bytes_allocated / 1024 << std::setw(13)
+                      << phase.counts.peak_live_bytes / 1024 << std::setw(10)
+                      << phase.counts.live_bytes / 1024 << std::setw(13) << phase.peak_rss_kb << "\n";
+        }
+    }
+}
+
+void writeJson(std::ostream& out, const std::vector<Benchmark>& benchmarks, const Options& options) {
+    out << std::setprecision(6) << "{\n  \"runs\": " << options.runs << ",\n  \"warmup\": "
+        << options.warmup << ",\n  \"benchmarks\": [";
+    for (size_t b = 0; b < benchmarks.size(); b++) {
+        const Benchmark& benchmark = benchmarks[b];
+        out << (b ? "," : "") << "\n    {\"name\": \"" << benchmark.name << "\", \"scale\": "
+            << benchmark.scale << ", \"results\": [";
+        for (size_t r = 0; r < benchmark.results.size(); r++) {
+            const Result& result = benchmark.results[r];
+            out << (r ? "," : "") << "\n      {\"language\": \"" << result.language << "\"";
+            if (!result.error.empty()) {
+                std::string error = result.error;
+                std::replace(error.begin(), error.end(), '"', '\'');
+                out << ", \"error\": \"" << error << "\"}";
+                continue;
+            }
+            out << ", \"min_ms\": " << result.min() << ", \"median_ms\": " << result.median()
+                << ", \"p95_ms\": " << result.percentile(95) << ", \"mean_ms\": " << result.mean()
+                << ", \"stddev_ms\": " << result.stddev() << ", \"peak_rss_kb\": "
+                << result.peak_rss_kb << ", \"samples_ms\": [";
+            for (size_t i = 0; i < result.samples_ms.size(); i++) {
+                out << (i ? ", " : "") << result.samples_ms[i];
+            }
+            out << "]";
+
+            // Counts per run of the events that could be opened
+            if (result.counted) {
+                const char* separator = "";
+                out << ", \"counters\": {";
+                for (int event = 0; event < caesar::PerfCounters::EVENT_COUNT; event++) {
+                    auto which = static_cast<caesar::PerfCounters::Event>(event);
+                    if (!options.perf_counters->available(which)) continue;
+                    out << separator << "\"" << caesar::PerfCounters::name(which)
+                        << "\": " << std::llround(result.counts_per_run[event]);
+                    separator = ", ";
+                }
+                out << "}";
+            }
+
+            if (!result.memory.empty()) {
+                out << ", \"memory\": {";
+                for (size_t i = 0; i < result.memory.size(); i++) {
+                    const PhaseMemory& phase = result.memory[i];
+                    out << (i ? ", " : "") << "\"" << phase.phase << "\": {\"allocations\": "
+                        << phase.counts.allocations << ", \"bytes_allocated\": "
+                        << phase.counts.bytes_allocated << ", \"peak_live_bytes\": "
+                        << phase.counts.peak_live_bytes << ", \"live_bytes\": "
+                        << phase.counts.live_bytes << ", \"peak_rss_kb\": " << phase.peak_rss_kb
+                        << "}";
+                }
+                out << "}";
+            }
+            out << "}";
+        }
+        out << "\n    ]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--runs=", 0) == 0) {
+            options.runs = std::atoi(arg.c_str() + 7);
+        } else if (arg.rfind("--warmup=", 0) == 0) {
+            options.warmup = std::atoi(arg.c_str() + 9);
+        } else if (arg.rfind("--json=", 0) == 0) {
+            options.json_output = arg.substr(7);
+        } else if (arg == "--caesar-only") {
+            options.caesar_only = true;
+        } else if (arg == "--no-micro") {
+            options.micro = false;
+        } else if (arg.rfind("--baseline=", 0) == 0) {
+            options.baseline = arg.substr(11);
+        } else if (arg.rfind("--threshold=", 0) == 0) {
+            options.threshold_percent = std::atof(arg.c_str() + 12);
+        } else if (arg.rfind("--alpha=", 0) == 0) {
+            options.alpha = std::atof(arg.c_str() + 8);
+        } else if (arg == "--counters") {
+            options.counters = true;
+        } else if (arg == "--memory") {
+            options.memory = true;
+        } else if (arg.rfind("--dir=", 0) == 0) {
+            options.directory = arg.substr(6);
+        } else if (arg[0] != '-') {
+            options.filters.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+    return options.runs > 0 && options.warmup >= 0 && options.threshold_percent >= 0 &&
+           options.alpha > 0 && options.alpha < 1;
+}
+
+/**
+ * @brief Names of the Caesar programs in the suite, sorted
+ */
+std::vector<std::string> listBenchmarks(const std::string& directory) {
+    std::vector<std::string> names;
+    std::string caesar_directory = directory + "/caesar";
+    std::unique_ptr<DIR, int (*)(DIR*)> dir(opendir(caesar_directory.c_str()), closedir);
+    if (!dir) return names;
+    while (dirent* entry = readdir(dir.get())) {
+        std::string file = entry->d_name;
+        if (file.size() > 4 && file.compare(file.size() - 4, 4, ".csr") == 0) {
+            names.push_back(file.substr(0, file.size() - 4));
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+/**
+ * @brief A parsed JSON value; enough to read back the files writeJson() produces
+ */
+struct JsonValue {
+    enum Kind { NONE, NUMBER, STRING, ARRAY, OBJECT } kind = NONE;
+    double number = 0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* member(const std::string& name) const {
+        for (const auto& entry : members) {
+            if (entry.first == name) return &entry.second;
+        }
+        return nullptr;
+    }
+};
+
+class JsonReader {
+    const std::string& text_;
+    size_t pos_ = 0;
+
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) pos_++;
+    }
+
+    void expect(char c) {
+        skipSpace();
+        if (pos_ >= text_.size() || text_[pos_] != c) {
+            throw std::runtime_error(std::string("expected '") + c + "' at offset " + std::to_string(pos_));
+        }
+        pos_++;
+    }
+
+    bool accept(char c) {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    std::string readString() {
+        expect('"');
+        std::string result;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) pos_++;
+            result += text_[pos_++];
+        }
+        expect('"');
+        return result;
+    }
+
+public:
+    explicit JsonReader(const std::string& text) : text_(text) {}
+
+    JsonValue read() {
+        JsonValue value;
+        skipSpace();
+        if (pos_ >= text_.size()) throw std::runtime_error("unexpected end of input");
+
+        char c = text_[pos_];
+        if (c == '{') {
+            value.kind = JsonValue::OBJECT;
+            pos_++;
+            if (accept('}')) return value;
+            do {
+                skipSpace();
+                std::string name = readString();
+                expect(':');
+                value.members.emplace_back(name, read());
+            } while (accept(','));
+            expect('}');
+        } else if (c == '[') {
+            value.kind = JsonValue::ARRAY;
+            pos_++;
+            if (accept(']')) return value;
+            do {
+                value.items.push_back(read());
+            } while (accept(','));
+            expect(']');
+        } else if (c == '"') {
+            value.kind = JsonValue::STRING;
+            value.text = readString();
+        } else {
+            char* end = nullptr;
+            value.kind = JsonValue::NUMBER;
+            value.number = std::strtod(text_.c_str() + pos_, &end);
+            if (end == text_.c_str() + pos_) {
+                throw std::runtime_error("unexpected '" + std::string(1, c) + "' at offset " +
+                                         std::to_string(pos_));
+            }
+            pos_ = end - text_.c_str();
+        }
+        return value;
+    }
+};
+
+/**
+ * @brief Caesar samples per benchmark name from a file written by --json
+ */
+std::map<std::string, std::vector<double>> readBaseline(const std::string& path) {
+    std::string text;
+    if (!readFile(path, text)) throw std::runtime_error("cannot read '" + path + "'");
+
+    std::map<std::string, std::vector<double>> baseline;
+    JsonValue root = JsonReader(text).read();
+    const JsonValue* benchmarks = root.member("benchmarks");
+    if (!benchmarks) throw std::runtime_error("'" + path + "' has no benchmarks");
+    for (const JsonValue& benchmark : benchmarks->items) {
+        const JsonValue* name = benchmark.member("name");
+        const JsonValue* results = benchmark.member("results");
+        if (!name || !results) continue;
+        for (const JsonValue& result : results->items) {
+            const JsonValue* language = result.member("language");
+            const JsonValue* samples = result.member("samples_ms");
+            if (!language || language->text != "caesar" || !samples) continue;
+            for (const JsonValue& sample : samples->items) {
+                baseline[name->text].push_back(sample.number);
+            }
+        }
+    }
+    return baseline;
+}
+
+/**
+ * @brief One-sided Mann-Whitney U test that current is slower than baseline
+ *
+ * Uses the normal approximation with tie and continuity corrections, which
+ * is adequate from about eight samples per side.
+ *
+ * @return The p-value of "current is not stochastically larger than baseline"
+ */
+double mannWhitneySlower(const std::vector<double>& baseline, const std::vector<double>& current) {
+    size_t n1 = baseline.size();
+    size_t n2 = current.size();
+    size_t n = n1 + n2;
+
+    // Rank the pooled samples, giving ties their average rank
+    std::vector<std::pair<double, bool>> pooled;  // (sample, from current)
+    for (double sample : baseline) pooled.emplace_back(sample, false);
+    for (double sample : current) pooled.emplace_back(sample, true);
+    std::sort(pooled.begin(), pooled.end());
+
+    double current_rank_sum = 0;
+    double tie_term = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && pooled[j].first == pooled[i].first) j++;
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++) {
+            if (pooled[k].second) current_rank_sum += rank;
+        }
+        double ties = static_cast<double>(j - i);
+        tie_term += ties * ties * ties - ties;
+        i = j;
+    }
+
+    double u = current_rank_sum - n2 * (n2 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (static_cast<double>(n) * (n - 1)));
+    if (variance <= 0) return 1;
+    double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/**
+ * @brief Print how each Caesar benchmark compares with the baseline
+ *
+ * @return The number of regressions
+ */
+int compareWithBaseline(const std::vector<Benchmark>& benchmarks,
+                        const std::map<std::string, std::vector<double>>& baseline,
+                        const Options& options) {
+    std::cout << std::defaultfloat << "\nCompared with " << options.baseline << " (threshold "
+              << options.threshold_percent << "%, alpha " << options.alpha << ")\n";
+    std::cout << std::left << std::setw(18) << "benchmark" << std::right << std::setw(13)
+              << "base median" << std::setw(11) << "median" << std::setw(10) << "change"
+              << std::setw(10) << "p" << "  verdict\n";
+
+    int regressions = 0;
+    for (const Benchmark& benchmark : benchmarks) {
+        auto previous = baseline.find(benchmark.name);
+        const Result& current = benchmark.results.front();
+        if (previous == baseline.end() || previous->second.empty() || !current.error.empty()) continue;
+
+        Result base;
+        base.samples_ms = previous->second;
+        double change = (current.median() / base.median() - 1) * 100;
+        double p_slower = mannWhitneySlower(base.samples_ms, current.samples_ms);
+        double p_faster = mannWhitneySlower(current.samples_ms, base.samples_ms);
+
+        const char* verdict = "same";
+        if (change > options.threshold_percent && p_slower < options.alpha) {
+            verdict = "REGRESSED";
+            regressions++;
+        } else if (-change > options.threshold_percent && p_faster < options.alpha) {
+            verdict = "improved";
+        }
+
+        std::cout << std::left << std::setw(18) << benchmark.name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(13) << base.median() << std::setw(11)
+                  << current.median() << std::setw(9) << std::showpos << change << std::noshowpos
+                  << "%" << std::setprecision(4) << std::setw(10) << std::min(p_slower, p_faster)
+                  << "  " << verdict << "\n";
+    }
+    return regressions;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: caesar_bench [--runs=<n>] [--warmup=<n>] [--json=<file>] "
+                     "[--caesar-only] [--no-micro] [--dir=<path>] [--baseline=<file>] "
+                     "[--threshold=<percent>] [--alpha=<p>] [--counters] [--memory] [benchmark...]\n";
+        return 1;
+    }
+
+    // Read the baseline first, so a bad file fails before the runs
+    std::map<std::string, std::vector<double>> baseline;
+    if (!options.baseline.empty()) {
+        try {
+            baseline = readBaseline(options.baseline);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Invalid baseline: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::string> names = listBenchmarks(options.directory);
+    if (names.empty()) {
+        std::cerr << "Error: No Caesar programs in '" << options.directory << "/caesar'\n";
+        return 1;
+    }
+
+    bool python_available = !options.caesar_only;
+    std::vector<Benchmark> benchmarks;
+    bool failed = false;
+
+    auto selected = [&](const std::string& name) {
+        return options.filters.empty() ||
+               std::find(options.filters.begin(), options.filters.end(), name) != options.filters.end();
+    };
+    auto report = [&](Benchmark&& benchmark) {
+        for (const Result& result : benchmark.results) {
+            printResult(benchmark.name, result);
+            failed = failed || !result.error.empty();
+        }
+        benchmarks.push_back(std::move(benchmark));
+    };
+
+    // Open the counters before any run, so its threads and children inherit them
+    caesar::PerfCounters counters;
+    if (options.counters) {
+        std::string error;
+        if (counters.open(error)) {
+            options.perf_counters = &counters;
+        } else {
+            std::cout << "Hardware counters unavailable (" << error << "), timing only\n";
+        }
+    }
+
+    std::cout << options.runs << " runs after " << options.warmup << " warmup\n\n";
+    printHeader();
+
+    std::string corpus;
+    for (const std::string& name : names) {
+        std::string source;
+        if (!readFile(options.directory + "/caesar/" + name + ".csr", source)) continue;
+        corpus += source + "\n";
+    }
+    if (options.micro) {
+        std::string repeated;
+        for (int i = 0; i < FRONT_END_REPEAT; i++) repeated += corpus;
+        if (selected("micro_lexer")) report({"micro_lexer", 0, {runLexerMicro(repeated, options)}});
+        if (selected("micro_parser")) report({"micro_parser", 0, {runParserMicro(repeated, options)}});
+        if (selected("micro_interpreter")) report({"micro_interpreter", 0, {runInterpreterMicro(options)}});
+    }
+
+    for (const std::string& name : names) {
+        if (!selected(name)) continue;
+
+        std::string source;
+        if (!readFile(options.directory + "/caesar/" + name + ".csr", source)) continue;
+
+        Benchmark benchmark;
+        benchmark.name = name;
+        benchmark.scale = findScale(source);
+        benchmark.results.push_back(runCaesar(source, options));
+        if (options.memory && benchmark.results.back().error.empty()) {
+            benchmark.results.back().memory = measurePhases(source);
+        }
+
+        // The other implementations take the problem size as their argument
+        if (!options.caesar_only && benchmark.scale > 0) {
+            std::string scale = std::to_string(benchmark.scale);
+            std::string cpp_binary = options.cpp_directory + "/" + name;
+            Result result;
+            if (access(cpp_binary.c_str(), X_OK) == 0 &&
+                runExternal("cpp", {cpp_binary, scale}, options, result)) {
+                benchmark.results.push_back(result);
+            }
+
+            result = Result();
+            std::string script = options.directory + "/python/" + name + ".py";
+            if (python_available && access(script.c_str(), R_OK) == 0) {
+                python_available = runExternal("python", {"python3", script, scale}, options, result);
+                if (python_available) benchmark.results.push_back(result);
+            }
+        }
+
+        report(std::move(benchmark));
+    }
+
+    if (options.perf_counters) printCounters(benchmarks, counters);
+    if (options.memory) printMemory(benchmarks);
+
+    if (!options.json_output.empty()) {
+        std::ofstream json(options.json_output);
+        if (!json.is_open()) {
+            std::cerr << "Error: Cannot write results to '" << options.json_output << "'\n";
+            return 1;
+        }
+        writeJson(json, benchmarks, options);
+    }
+
+    int regressions = options.baseline.empty() ? 0 : compareWithBaseline(benchmarks, baseline, options);
+    if (failed) return 1;
+    return regressions > 0 ? 2 : 0;
+}
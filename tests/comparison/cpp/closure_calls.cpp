@@ -0,0 +1,49 @@
+#include <iostream>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+/**
+ * Closure call benchmark for C++
+ * Usage: ./closure_calls <iterations>
+ */
+
+// Keep the calls from being inlined away
+__attribute__((noinline)) long long first(const std::vector<long long>& items, size_t index) {
+    return items[index];
+}
+
+std::function<long long(long long)> make_adder(long long step) {
+    return [step](long long total) { return total + step; };
+}
+
+long long call_loop(int n) {
+    // Call a closure and a list-taking function n times - standardized across all languages
+    std::vector<long long> items = {1, 2, 3};
+    std::function<long long(long long)> add = make_adder(1);
+    long long total = 0;
+    for (int i = 0; i < n; ++i) {
+        total = add(total) + first(items, 0);
+    }
+    return total;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <iterations>" << std::endl;
+        return 1;
+    }
+    
+    int n = std::atoi(argv[1]);
+    if (n < 0) {
+        std::cerr << "Error: iterations must be non-negative" << std::endl;
+        return 1;
+    }
+    
+    long long result = call_loop(n);
+    (void)result;
+    
+    // Don't print result to avoid affecting timing
+    
+    return 0;
+}
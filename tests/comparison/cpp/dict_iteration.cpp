@@ -0,0 +1,41 @@
+#include <iostream>
+#include <unordered_map>
+#include <cstdlib>
+
+/**
+ * Dict iteration benchmark for C++
+ * Usage: ./dict_iteration <iterations>
+ */
+
+long long iterate_keys(int n) {
+    // Iterate over n keys - standardized across all languages
+    std::unordered_map<long long, long long> table;
+    for (int i = 0; i < n; ++i) {
+        table[i] = i;
+    }
+    long long total = 0;
+    for (const auto& entry : table) {
+        total += entry.first;
+    }
+    return total;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <iterations>" << std::endl;
+        return 1;
+    }
+    
+    int n = std::atoi(argv[1]);
+    if (n < 0) {
+        std::cerr << "Error: iterations must be non-negative" << std::endl;
+        return 1;
+    }
+    
+    long long result = iterate_keys(n);
+    (void)result;
+    
+    // Don't print result to avoid affecting timing
+    
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <iostream>
+#include <cstdlib>
+
+/**
+ * Function call benchmark for C++
+ * Usage: ./function_calls <iterations>
+ */
+
+// Keep the call from being inlined away
+__attribute__((noinline)) long long add(long long a, long long b) {
+    return a + b;
+}
+
+long long call_loop(int n) {
+    // Call a trivial function n times - standardized across all languages
+    long long total = 0;
+    for (int i = 0; i < n; ++i) {
+        total = add(total, i);
+    }
+    return total;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <iterations>" << std::endl;
+        return 1;
+    }
+    
+    int n = std::atoi(argv[1]);
+    if (n < 0) {
+        std::cerr << "Error: iterations must be non-negative" << std::endl;
+        return 1;
+    }
+    
+    long long result = call_loop(n);
+    (void)result;
+    
+    // Don't print result to avoid affecting timing
+    
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+/**
+ * String builder benchmark for C++
+ * Usage: ./string_builder <iterations>
+ */
+
+int build_string(int n) {
+    // Repeated append - standardized across all languages
+    std::string result = "";
+    for (int i = 0; i < n; ++i) {
+        result += "x";
+    }
+    return result.length();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <iterations>" << std::endl;
+        return 1;
+    }
+    
+    int n = std::atoi(argv[1]);
+    if (n < 0) {
+        std::cerr << "Error: iterations must be non-negative" << std::endl;
+        return 1;
+    }
+    
+    int result = build_string(n);
+    (void)result;
+    
+    // Don't print result to avoid affecting timing
+    
+    return 0;
+}
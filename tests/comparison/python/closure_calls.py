@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+"""
+Closure call benchmark for Python
+Usage: python closure_calls.py <iterations>
+"""
+
+import sys
+
+def first(items, index):
+    return items[index]
+
+def make_adder(step):
+    def add(total):
+        return total + step
+    return add
+
+def call_loop(n):
+    """Call a closure and a list-taking function n times - standardized across all languages"""
+    items = [1, 2, 3]
+    add = make_adder(1)
+    total = 0
+    i = 0
+    while i < n:
+        total = add(total) + first(items, 0)
+        i = i + 1
+    return total
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: python closure_calls.py <iterations>")
+        sys.exit(1)
+    
+    try:
+        n = int(sys.argv[1])
+    except ValueError:
+        print("Error: iterations must be an integer")
+        sys.exit(1)
+    
+    if n < 0:
+        print("Error: iterations must be non-negative")
+        sys.exit(1)
+    
+    result = call_loop(n)
+    
+    # Don't print result to avoid affecting timing
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+"""
+Dict iteration benchmark for Python
+Usage: python dict_iteration.py <iterations>
+"""
+
+import sys
+
+def iterate_keys(n):
+    """Iterate over n keys - standardized across all languages"""
+    table = {}
+    i = 0
+    while i < n:
+        table[i] = i
+        i = i + 1
+    total = 0
+    for key in table:
+        total = total + key
+    return total
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: python dict_iteration.py <iterations>")
+        sys.exit(1)
+    
+    try:
+        n = int(sys.argv[1])
+    except ValueError:
+        print("Error: iterations must be an integer")
+        sys.exit(1)
+    
+    if n < 0:
+        print("Error: iterations must be non-negative")
+        sys.exit(1)
+    
+    result = iterate_keys(n)
+    
+    # Don't print result to avoid affecting timing
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+"""
+Dict lookup benchmark for Python
+Usage: python dict_lookup.py <iterations>
+"""
+
+import sys
+
+def lookup_keys(n):
+    """Look up n string keys - standardized across all languages"""
+    table = {}
+    i = 0
+    while i < n:
+        table[str(i)] = i
+        i = i + 1
+    total = 0
+    i = 0
+    while i < n:
+        total = total + table[str(i)]
+        i = i + 1
+    return total
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: python dict_lookup.py <iterations>")
+        sys.exit(1)
+    
+    try:
+        n = int(sys.argv[1])
+    except ValueError:
+        print("Error: iterations must be an integer")
+        sys.exit(1)
+    
+    if n < 0:
+        print("Error: iterations must be non-negative")
+        sys.exit(1)
+    
+    result = lookup_keys(n)
+    
+    # Don't print result to avoid affecting timing
+
+if __name__ == "__main__":
+    main()
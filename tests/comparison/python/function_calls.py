@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+"""
+Function call benchmark for Python
+Usage: python function_calls.py <iterations>
+"""
+
+import sys
+
+def add(a, b):
+    return a + b
+
+def call_loop(n):
+    """Call a trivial function n times - standardized across all languages"""
+    total = 0
+    i = 0
+    while i < n:
+        total = add(total, i)
+        i = i + 1
+    return total
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: python function_calls.py <iterations>")
+        sys.exit(1)
+    
+    try:
+        n = int(sys.argv[1])
+    except ValueError:
+        print("Error: iterations must be an integer")
+        sys.exit(1)
+    
+    if n < 0:
+        print("Error: iterations must be non-negative")
+        sys.exit(1)
+    
+    result = call_loop(n)
+    
+    # Don't print result to avoid affecting timing
+
+if __name__ == "__main__":
+    main()
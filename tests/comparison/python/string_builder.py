@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+"""
+String builder benchmark for Python
+Usage: python string_builder.py <iterations>
+"""
+
+import sys
+
+def build_string(n):
+    """Repeated append - standardized across all languages"""
+    result = ""
+    i = 0
+    while i < n:
+        result = result + "x"
+        i = i + 1
+    return len(result)
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: python string_builder.py <iterations>")
+        sys.exit(1)
+    
+    try:
+        n = int(sys.argv[1])
+    except ValueError:
+        print("Error: iterations must be an integer")
+        sys.exit(1)
+    
+    if n < 0:
+        print("Error: iterations must be non-negative")
+        sys.exit(1)
+    
+    result = build_string(n)
+    
+    # Don't print result to avoid affecting timing
+
+if __name__ == "__main__":
+    main()
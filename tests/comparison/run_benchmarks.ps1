@@ -44,6 +44,36 @@ $Categories = @{
         "description" = "String manipulation and processing"
         "scales" = @(1000, 10000, 100000)
     }
+    "string_builder" = @{
+        "name" = "String Builder"
+        "description" = "Repeated append to a growing string"
+        "scales" = @(10000, 100000, 1000000)
+    }
+    "function_calls" = @{
+        "name" = "Function Calls"
+        "description" = "Call and return latency of a trivial function"
+        "scales" = @(100000, 1000000, 10000000)
+    }
+    "closure_calls" = @{
+        "name" = "Closure Calls"
+        "description" = "Calling a closure and passing a list as an argument"
+        "scales" = @(100000, 1000000, 10000000)
+    }
+    "dict_insert" = @{
+        "name" = "Dict Insert"
+        "description" = "Inserting int keys into a dict"
+        "scales" = @(10000, 100000, 1000000)
+    }
+    "dict_lookup" = @{
+        "name" = "Dict Lookup"
+        "description" = "Looking up string keys in a dict"
+        "scales" = @(10000, 100000, 1000000)
+    }
+    "dict_iteration" = @{
+        "name" = "Dict Iteration"
+        "description" = "Iterating over the keys of a dict"
+        "scales" = @(10000, 100000, 1000000)
+    }
 }
 
 # Results storage
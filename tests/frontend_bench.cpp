@@ -0,0 +1,229 @@
+/**
+ * @file frontend_bench.cpp
+ * @brief Lexer and parser throughput on synthetic corpora
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ *
+ * Usage: frontend_bench [--size=<KB>] [--depth=<n>] [--terms=<n>] [--runs=<n>] [shape...]
+ *
+ * Generates a corpus of about --size KB (1024 by default) for each shape:
+ *
+ *   nesting      functions of if/while/for blocks nested --depth deep (16)
+ *   expressions  assignments of arithmetic and logical expressions with
+ *                --terms operands each (64)
+ *   functions    many two-line functions
+ *   strings      string literals with escapes, concatenated and printed
+ *   mixed        all of the above, interleaved
+ *
+ * and reports the median over --runs runs (5) of Lexer::tokenize in MB/s
+ * and Parser::parse in million tokens/s, plus the bytes the AST keeps
+ * allocated per source byte. Allocations are counted by alloc_counter,
+ * which adds a few nanoseconds to each one in both phases.
+ */
+
+#include "alloc_counter.h"
+#include "caesar/lexer.h"
+#include "caesar/parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    size_t size_kb = 1024;
+    int depth = 16;
+    int terms = 64;
+    int runs = 5;
+    std::vector<std::string> shapes;
+};
+
+/// Appends one unit of a shape; k numbers the unit so names stay distinct
+using Generator = std::function<void(std::string& out, int k, const Options& options)>;
+
+void generateNesting(std::string& out, int k, const Options& options) {
+    static const char* const OPENERS[] = {"if a > %:", "while a < %:", "for j in range(%):", "if a == %:"};
+
+    out += "def nest_" + std::to_string(k) + "(a):\n";
+    std::string indent = "    ";
+    for (int level = 0; level < options.depth; level++) {
+        std::string opener = OPENERS[level % 4];
+        opener.replace(opener.find('%'), 1, std::to_string(level + k % 7));
+        out += indent + opener + "\n";
+        indent += "    ";
+    }
+    out += indent + "a = a + 1\n";
+    out += "    return a\n\n";
+}
+
+void generateExpressions(std::string& out, int k, const Options& options) {
+    static const char* const OPERATORS[] = {" + ", " * ", " - ", " / ", " % ", " < ", " and ", " or "};
+
+    out += "e_" + std::to_string(k) + " = ";
+    for (int term = 0; term < options.terms; term++) {
+        if (term > 0) out += OPERATORS[(term + k) % 8];
+        // Every fourth operand is a parenthesized pair
+        if (term % 4 == 3) {
+            out += "(v" + std::to_string(term) + " - " + std::to_string(term * k % 1000) + ")";
+        } else if (term % 2) {
+            out += std::to_string(term * 31 + k);
+        } else {
+            out += "x" + std::to_string(term);
+        }
+    }
+    out += "\n";
+}
+
+void generateFunctions(std::string& out, int k, const Options&) {
+    std::string n = std::to_string(k);
+    out += "def f_" + n + "(a, b):\n    return a + b * " + n + "\n\n";
+}
+
+void generateStrings(std::string& out, int k, const Options&) {
+    std::string n = std::to_string(k);
+    out += "s_" + n + " = \"line " + n + " with \\\"quotes\\\", a tab\\t and a newline\\n\" + 'single " + n +
+           "'\n";
+    out += "print(s_" + n + ", \"suffix\", '" + n + "')\n";
+}
+
+const std::vector<std::pair<std::string, Generator>>& shapes() {
+    static const std::vector<std::pair<std::string, Generator>> all = {
+        {"nesting", generateNesting},
+        {"expressions", generateExpressions},
+        {"functions", generateFunctions},
+        {"strings", generateStrings},
+        {"mixed",
+         [](std::string& out, int k, const Options& options) {
+             switch (k % 4) {
+                 case 0: generateNesting(out, k, options); break;
+                 case 1: generateExpressions(out, k, options); break;
+                 case 2: generateFunctions(out, k, options); break;
+                 default: generateStrings(out, k, options); break;
+             }
+         }},
+    };
+    return all;
+}
+
+std::string generateCorpus(const Generator& generate, const Options& options) {
+    std::string corpus;
+    size_t target = options.size_kb * 1024;
+    corpus.reserve(target + 4096);
+    for (int k = 0; corpus.size() < target; k++) generate(corpus, k, options);
+    return corpus;
+}
+
+double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    size_t middle = samples.size() / 2;
+    return samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+}
+
+struct Measurement {
+    size_t tokens = 0;
+    double lex_mb_per_s = 0;
+    double parse_mtokens_per_s = 0;
+    double ast_bytes_per_source_byte = 0;
+};
+
+Measurement measure(const std::string& corpus, const Options& options) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> lex_seconds;
+    std::vector<double> parse_seconds;
+    Measurement result;
+
+    for (int run = 0; run < options.runs; run++) {
+        auto start = Clock::now();
+        caesar::Lexer lexer(corpus);
+        std::vector<caesar::Token> tokens = lexer.tokenize();
+        lex_seconds.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+        result.tokens = tokens.size();
+
+        // The parser keeps the tokens until it is destroyed, so the growth is the AST
+        caesar::Parser parser(std::move(tokens));
+        auto before = caesar::alloc_counter::current();
+        start = Clock::now();
+        auto program = parser.parse();
+        parse_seconds.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+        auto after = caesar::alloc_counter::current();
+        result.ast_bytes_per_source_byte =
+            static_cast<double>(caesar::alloc_counter::since(before, after).live_bytes) / corpus.size();
+    }
+
+    result.lex_mb_per_s = corpus.size() / median(lex_seconds) / 1e6;
+    result.parse_mtokens_per_s = result.tokens / median(parse_seconds) / 1e6;
+    return result;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--size=", 0) == 0) {
+            options.size_kb = std::strtoull(arg.c_str() + 7, nullptr, 10);
+        } else if (arg.rfind("--depth=", 0) == 0) {
+            options.depth = std::atoi(arg.c_str() + 8);
+        } else if (arg.rfind("--terms=", 0) == 0) {
+            options.terms = std::atoi(arg.c_str() + 8);
+        } else if (arg.rfind("--runs=", 0) == 0) {
+            options.runs = std::atoi(arg.c_str() + 7);
+        } else if (arg[0] != '-') {
+            options.shapes.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+    return options.size_kb > 0 && options.depth > 0 && options.terms > 0 && options.runs > 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: frontend_bench [--size=<KB>] [--depth=<n>] [--terms=<n>] [--runs=<n>] "
+                     "[nesting|expressions|functions|strings|mixed...]\n";
+        return 1;
+    }
+    for (const std::string& shape : options.shapes) {
+        auto known = std::find_if(shapes().begin(), shapes().end(),
+                                  [&](const auto& entry) { return entry.first == shape; });
+        if (known == shapes().end()) {
+            std::cerr << "Error: Unknown shape '" << shape << "'\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Median of " << options.runs << " runs, corpora of about " << options.size_kb
+              << " KB\n\n";
+    std::cout << std::left << std::setw(13) << "shape" << std::right << std::setw(10) << "KB"
+              << std::setw(11) << "tokens" << std::setw(11) << "lex MB/s" << std::setw(14)
+              << "parse Mtok/s" << std::setw(14) << "AST B/src B" << "\n";
+
+    for (const auto& [name, generate] : shapes()) {
+        if (!options.shapes.empty() &&
+            std::find(options.shapes.begin(), options.shapes.end(), name) == options.shapes.end()) {
+            continue;
+        }
+
+        std::string corpus = generateCorpus(generate, options);
+        Measurement result;
+        try {
+            result = measure(corpus, options);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << name << ": " << e.what() << "\n";
+            return 1;
+        }
+
+        std::cout << std::left << std::setw(13) << name << std::right << std::setw(10)
+                  << corpus.size() / 1024 << std::setw(11) << result.tokens << std::fixed
+                  << std::setprecision(1) << std::setw(11) << result.lex_mb_per_s << std::setprecision(2)
+                  << std::setw(14) << result.parse_mtokens_per_s << std::setprecision(1)
+                  << std::setw(14) << result.ast_bytes_per_source_byte << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file gc_pause_bench.cpp
+ * @brief Garbage collector pause times on a large live heap
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ *
+ * Usage: gc_pause_bench [live_objects] [max_pause_us]
+ *
+ * Builds a heap of live lists (10M by default), then runs a mutator that
+ * keeps replacing live lists and dropping garbage cycles until a full
+ * collection has completed. This is done once with atomic collections and
+ * once with the given pause budget (1000 us by default), printing the
+ * p50/p99/max pause of each run.
+ */
+
+#include "caesar/gc.h"
+#include "caesar/list_object.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Live lists held by each holder list
+constexpr size_t FANOUT = 100;
+
+struct RunResult {
+    double p50_us;
+    double p99_us;
+    double max_us;
+    size_t pauses;
+    double seconds;
+};
+
+RunResult run(std::vector<caesar::Ref<caesar::ListObject>>& holders,
+              std::chrono::microseconds budget) {
+    caesar::GcHeap& heap = caesar::GcHeap::instance();
+    heap.setMaxPause(budget);
+
+    caesar::GcStats before = heap.stats();
+    uint64_t full_collections = before.full_collections;
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t state = 88172645463325252ull;
+    while (heap.stats().full_collections == full_collections) {
+        // xorshift64, so both runs replace the same lists
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        auto garbage = caesar::makeRef<caesar::ListObject>();
+        garbage->append(garbage);
+
+        auto replacement = caesar::makeRef<caesar::ListObject>();
+        replacement->append(static_cast<int64_t>(state));
+        holders[state % holders.size()]->set((state >> 32) % FANOUT, replacement);
+
+        heap.maybeCollect();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Only count the pauses of this run
+    caesar::GcStats run_stats;
+    run_stats.pauses_us.assign(heap.stats().pauses_us.begin() + before.pauses_us.size(),
+                               heap.stats().pauses_us.end());
+    return RunResult{run_stats.pausePercentile(50), run_stats.pausePercentile(99),
+                     run_stats.pausePercentile(100), run_stats.pauses_us.size(),
+                     elapsed.count()};
+}
+
+void report(const char* mode, const RunResult& result) {
+    std::cout << std::left << std::setw(22) << mode << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << result.p50_us << std::setw(10)
+              << result.p99_us << std::setw(12) << result.max_us << std::setw(9)
+              << result.pauses << std::setprecision(2) << std::setw(9) << result.seconds
+              << "\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    size_t live_objects = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    long long budget_us = argc > 2 ? std::strtoll(argv[2], nullptr, 10) : 1000;
+    if (live_objects < FANOUT || budget_us <= 0) {
+        std::cerr << "Usage: gc_pause_bench [live_objects >= " << FANOUT
+                  << "] [max_pause_us > 0]\n";
+        return 1;
+    }
+
+    caesar::GcHeap& heap = caesar::GcHeap::instance();
+
+    // Build the live heap with the collector idle, then promote it all at once
+    std::cout << "Building " << live_objects << " live objects...\n";
+    std::vector<caesar::Ref<caesar::ListObject>> holders(live_objects / FANOUT);
+    for (auto& holder : holders) {
+        holder = caesar::makeRef<caesar::ListObject>();
+        for (size_t i = 0; i < FANOUT; i++) {
+            auto leaf = caesar::makeRef<caesar::ListObject>();
+            leaf->append(static_cast<int64_t>(i));
+            holder->append(leaf);
+        }
+    }
+    heap.collect();
+    std::cout << heap.trackedCount() << " objects tracked\n\n";
+
+    std::cout << std::left << std::setw(22) << "mode" << std::right << std::setw(10)
+              << "p50 us" << std::setw(10) << "p99 us" << std::setw(12) << "max us"
+              << std::setw(9) << "pauses" << std::setw(9) << "wall s" << "\n";
+    report("atomic", run(holders, std::chrono::microseconds(0)));
+
+    std::string incremental = "incremental " + std::to_string(budget_us) + " us";
+    report(incremental.c_str(), run(holders, std::chrono::microseconds(budget_us)));
+
+    heap.setMaxPause(std::chrono::microseconds(0));
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file perf_counters.cpp
+ * @brief Hardware performance counters around benchmark runs
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define CAESAR_HAS_PERF_EVENTS 1
+#endif
+
+namespace caesar {
+
+namespace {
+
+#ifdef CAESAR_HAS_PERF_EVENTS
+/// Read misses of a cache, as a PERF_TYPE_HW_CACHE config
+constexpr uint64_t cacheReadMisses(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+const EventConfig EVENT_CONFIGS[PerfCounters::EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_DTLB)},
+};
+#endif
+
+} // anonymous namespace
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef CAESAR_HAS_PERF_EVENTS
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+const char* PerfCounters::name(Event event) {
+    switch (event) {
+        case CYCLES: return "cycles";
+        case INSTRUCTIONS: return "instructions";
+        case BRANCH_MISSES: return "branch_misses";
+        case L1D_MISSES: return "l1d_misses";
+        case LLC_MISSES: return "llc_misses";
+        case DTLB_MISSES: return "dtlb_misses";
+        default: return "unknown";
+    }
+}
+
+bool PerfCounters::open(std::string& error) {
+#ifdef CAESAR_HAS_PERF_EVENTS
+    bool any = false;
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = EVENT_CONFIGS[event].type;
+        attributes.config = EVENT_CONFIGS[event].config;
+        attributes.disabled = 1;
+        attributes.inherit = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        if (fd < 0) {
+            if (error.empty()) error = std::string("perf_event_open: ") + std::strerror(errno);
+            continue;
+        }
+        fds_[event] = fd;
+        any = true;
+    }
+    if (any) error.clear();
+    return any;
+#else
+    error = "hardware counters need Linux perf_event_open";
+    return false;
+#endif
+}
+
+bool PerfCounters::readCounter(Event event, Reading& reading) const {
+#ifdef CAESAR_HAS_PERF_EVENTS
+    return fds_[event] >= 0 &&
+           read(fds_[event], reading.data(), sizeof(reading)) == static_cast<ssize_t>(sizeof(reading));
+#else
+    (void)event;
+    (void)reading;
+    return false;
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef CAESAR_HAS_PERF_EVENTS
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        if (fds_[event] < 0) continue;
+        ioctl(fds_[event], PERF_EVENT_IOC_ENABLE, 0);
+        readCounter(static_cast<Event>(event), started_[event]);
+    }
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef CAESAR_HAS_PERF_EVENTS
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        if (fds_[event] < 0) continue;
+        ioctl(fds_[event], PERF_EVENT_IOC_DISABLE, 0);
+
+        Reading stopped;
+        if (!readCounter(static_cast<Event>(event), stopped)) continue;
+        double value = static_cast<double>(stopped[0] - started_[event][0]);
+        uint64_t enabled = stopped[1] - started_[event][1];
+        uint64_t running = stopped[2] - started_[event][2];
+        // Scale multiplexed counts up to the whole interval
+        if (running > 0 && running < enabled) value *= static_cast<double>(enabled) / running;
+        totals_[event] += value;
+    }
+#endif
+}
+
+} // namespace caesar
@@ -0,0 +1,91 @@
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters around benchmark runs
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#ifndef CAESAR_PERF_COUNTERS_H
+#define CAESAR_PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace caesar {
+
+/**
+ * @brief Counts CPU events of this process, its later threads and children
+ *
+ * Uses Linux perf_event_open. Each event is opened on its own, so events
+ * the CPU or the kernel does not offer are left out without affecting the
+ * others. In containers, or with a restrictive perf_event_paranoid, often
+ * none can be opened and open() returns false. When more events are open
+ * than the CPU has counters, the kernel multiplexes them and the counts
+ * are scaled up by the fraction of time each one ran.
+ *
+ * The counters are inherited by threads and processes created after
+ * open(), so they include the interpreter's thread and children run by
+ * fork(). A child's counts are added when it exits.
+ */
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        LLC_MISSES,
+        DTLB_MISSES,
+        EVENT_COUNT
+    };
+
+    using Counts = std::array<double, EVENT_COUNT>;
+
+private:
+    /// Raw counter readings: value, time enabled, time running
+    using Reading = std::array<uint64_t, 3>;
+
+    std::array<int, EVENT_COUNT> fds_;
+    std::array<Reading, EVENT_COUNT> started_{};
+    Counts totals_{};
+
+    bool readCounter(Event event, Reading& reading) const;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    static const char* name(Event event);
+
+    /**
+     * @brief Open every event that is available
+     *
+     * @param error Set to the reason when none is
+     * @return true if at least one event could be opened
+     */
+    bool open(std::string& error);
+
+    bool available(Event event) const { return fds_[event] >= 0; }
+
+    /**
+     * @brief Count from now until stop()
+     */
+    void start();
+
+    /**
+     * @brief Stop counting and add the counts since start() to totals()
+     */
+    void stop();
+
+    /// Counts of unavailable events stay 0
+    const Counts& totals() const { return totals_; }
+    void clearTotals() { totals_.fill(0); }
+};
+
+} // namespace caesar
+
+#endif // CAESAR_PERF_COUNTERS_H
@@ -0,0 +1,1284 @@
+/**
+ * @file test_interpreter.cpp
+ * @brief Tests for the Caesar AST interpreter
+ * @author J.J.G. Pleunes
+ * @version 1.0.0
+ */
+
+#undef NDEBUG
+#include "caesar/lexer.h"
+#include "caesar/parser.h"
+#include "caesar/ast.h"
+#include "caesar/interpreter.h"
+#include "caesar/resolver.h"
+#include "caesar/gc.h"
+#include "caesar/execution_stats.h"
+#include "caesar/tracer.h"
+#include <chrono>
+#include <iostream>
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdlib>
+#include <new>
+
+// Ensure std types are available
+using std::vector;
+
+// Simple assert replacement for debugging
+#define my_assert(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << "Assertion failed: " << #condition << " at line " << __LINE__ << std::endl; \
+            std::abort(); \
+        } \
+    } while(0)
+
+#ifndef assert
+#define assert my_assert
+#endif
+
+// Count heap allocations so tests can check that hot paths do not allocate
+static size_t allocation_count = 0;
+
+void* operator new(size_t size) {
+    allocation_count++;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+// Helper function to run a program and return the value of its last expression
+caesar::Value run(const std::string& source) {
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    return interpreter.interpret(program.get());
+}
+
+// Helper function to check that a program fails with a runtime error
+bool failsAtRuntime(const std::string& source) {
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    try {
+        program->accept(interpreter);
+    } catch (const caesar::RuntimeError&) {
+        return true;
+    }
+    return false;
+}
+
+// Helper function to find the first binary expression in an expression statement
+caesar::BinaryExpression* firstBinary(caesar::Program& program, size_t index) {
+    auto stmt = dynamic_cast<caesar::ExpressionStatement*>(program.statements[index].get());
+    assert(stmt != nullptr);
+    auto assign = dynamic_cast<caesar::AssignmentExpression*>(stmt->expression.get());
+    auto expr = assign ? assign->value.get() : stmt->expression.get();
+    return dynamic_cast<caesar::BinaryExpression*>(expr);
+}
+
+void test_binary_arithmetic() {
+    std::cout << "Testing binary arithmetic...\n";
+
+    assert(std::get<int64_t>(run("1 + 2 * 3\n")) == 7);
+    assert(std::get<int64_t>(run("17 % 5\n")) == 2);
+    assert(std::get<double>(run("7 / 2\n")) == 3.5);
+    assert(std::get<double>(run("1.5 + 2\n")) == 3.5);
+    assert(std::get<double>(run("2 * 0.25\n")) == 0.5);
+    assert(std::get<bool>(run("3 <= 3.0\n")) == true);
+    assert(std::get<caesar::String>(run("\"ab\" + \"cd\"\n")) == "abcd");
+    assert(std::get<bool>(run("\"abc\" < \"abd\"\n")) == true);
+    assert(std::get<bool>(run("1 and 0\n")) == false);
+
+    assert(failsAtRuntime("1 / 0\n"));
+    assert(failsAtRuntime("1 % 0\n"));
+    assert(failsAtRuntime("\"a\" - \"b\"\n"));
+
+    std::cout << "✓ Binary arithmetic tests passed\n";
+}
+
+void test_binary_specialization() {
+    std::cout << "Testing binary node specialization...\n";
+
+    std::string source = R"(
+a = 1
+b = 2
+c = a + b
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    auto binary = firstBinary(*program, 2);
+    assert(binary != nullptr);
+    assert(binary->specialization == caesar::BinarySpecialization::UNSPECIALIZED);
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+    assert(binary->specialization == caesar::BinarySpecialization::INT_INT);
+    assert(binary->handler == caesar::BinaryHandler::INT_ADD);
+
+    // Each operator gets its own handler, so repeated evaluation takes the fast path
+    std::string loop = R"(
+def check(a, b):
+    return [a + b, a - b, a * b, a / b, a == b, a != b, a < b, a <= b, a > b, a >= b]
+
+ints = check(7, 2)
+ints = check(7, 2)
+modulo = 0
+for i in range(3):
+    modulo = modulo + 7 % 4
+floats = check(1.5, 0.5)
+floats = check(1.5, 0.5)
+)";
+    caesar::Lexer loop_lexer(loop);
+    caesar::Parser loop_parser(loop_lexer.tokenize());
+    auto loop_program = loop_parser.parse();
+    caesar::Interpreter loop_interpreter;
+    loop_interpreter.interpret(loop_program.get());
+
+    auto env = loop_interpreter.getCurrentEnvironment();
+    auto ints = std::get<caesar::Ref<caesar::ListObject>>(env->get("ints"));
+    assert(std::get<int64_t>(ints->get(0)) == 9);
+    assert(std::get<int64_t>(ints->get(1)) == 5);
+    assert(std::get<int64_t>(ints->get(2)) == 14);
+    assert(std::get<double>(ints->get(3)) == 3.5);
+    assert(std::get<bool>(ints->get(4)) == false);
+    assert(std::get<bool>(ints->get(9)) == true);
+    assert(std::get<int64_t>(env->get("modulo")) == 9);
+
+    // The operands changed type, so the same nodes now use the float handlers
+    auto floats = std::get<caesar::Ref<caesar::ListObject>>(env->get("floats"));
+    assert(std::get<double>(floats->get(0)) == 2.0);
+    assert(std::get<double>(floats->get(3)) == 3.0);
+    assert(std::get<bool>(floats->get(7)) == false);
+    assert(std::get<bool>(floats->get(8)) == true);
+
+    std::cout << "✓ Binary node specialization tests passed\n";
+}
+
+void test_binary_deoptimization() {
+    std::cout << "Testing binary node deoptimization...\n";
+
+    // The same '+' node sees int, float and string operands in turn
+    std::string source = R"(
+def add(a, b):
+    return a + b
+
+r1 = add(1, 2)
+r2 = add(1.5, 2.5)
+r3 = add(1, 0.5)
+r4 = add("x", "y")
+r5 = add(10, 20)
+r6 = add(1, 2)
+r7 = add(0.5, 0.25)
+r1
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    assert(std::get<int64_t>(env->get("r1")) == 3);
+    assert(std::get<double>(env->get("r2")) == 4.0);
+    assert(std::get<double>(env->get("r3")) == 1.5);
+    assert(std::get<caesar::String>(env->get("r4")) == "xy");
+    assert(std::get<int64_t>(env->get("r5")) == 30);
+    assert(std::get<int64_t>(env->get("r6")) == 3);
+    assert(std::get<double>(env->get("r7")) == 0.75);
+
+    // A site whose guard keeps failing settles on the generic path
+    auto func = dynamic_cast<caesar::FunctionDefinition*>(program->statements[0].get());
+    auto body = dynamic_cast<caesar::BlockStatement*>(func->body.get());
+    auto ret = dynamic_cast<caesar::ReturnStatement*>(body->statements[0].get());
+    auto binary = dynamic_cast<caesar::BinaryExpression*>(ret->value.get());
+    assert(binary != nullptr);
+    assert(binary->specialization == caesar::BinarySpecialization::GENERIC);
+    assert(binary->handler == caesar::BinaryHandler::GENERIC);
+
+    std::cout << "✓ Binary node deoptimization tests passed\n";
+}
+
+void test_string_concatenation() {
+    std::cout << "Testing string concatenation...\n";
+
+    // Strings that share a buffer must not see each other's appends
+    std::string source = R"(
+a = "ab"
+b = a + "c"
+c = a + "d"
+d = b + b
+e = ""
+i = 0
+while i < 1000:
+    e = e + "x"
+    i = i + 1
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    assert(std::get<caesar::String>(env->get("a")) == "ab");
+    assert(std::get<caesar::String>(env->get("b")) == "abc");
+    assert(std::get<caesar::String>(env->get("c")) == "abd");
+    assert(std::get<caesar::String>(env->get("d")) == "abcabc");
+    assert(std::get<caesar::String>(env->get("e")).view() == std::string(1000, 'x'));
+
+    std::cout << "✓ String concatenation tests passed\n";
+}
+
+void test_string_interning() {
+    std::cout << "Testing string interning...\n";
+
+    caesar::String a = caesar::String::intern("caesar");
+    caesar::String b = caesar::String::intern(std::string("cae") + "sar");
+    caesar::String c("caesar");
+    assert(a.isInterned() && b.isInterned() && !c.isInterned());
+    assert(a.data() == b.data());
+    assert(a == b && a == c && c == a);
+    assert(a.hash() == c.hash());
+    assert(caesar::String::intern("caesar!") != a);
+
+    // Equal literals evaluate to the same interned object
+    std::string source = R"(
+x = "hello"
+y = "hello"
+z = x
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    caesar::String x = std::get<caesar::String>(env->get("x"));
+    caesar::String y = std::get<caesar::String>(env->get("y"));
+    caesar::String z = std::get<caesar::String>(env->get("z"));
+    assert(x.isInterned() && x.data() == y.data() && x.data() == z.data());
+
+    std::cout << "✓ String interning tests passed\n";
+}
+
+void test_list_storage_strategies() {
+    std::cout << "Testing list storage strategies...\n";
+
+    std::string source = R"(
+ints = [1, 2, 3]
+floats = [0.5, 1.5]
+mixed = [1, 2]
+mixed.append("x")
+empty = []
+reused = [1]
+reused.pop()
+reused.append(2.5)
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    using caesar::ListObject;
+    auto env = interpreter.getCurrentEnvironment();
+    auto list = [&](const char* name) {
+        return std::get<caesar::Ref<ListObject>>(env->get(name));
+    };
+    assert(list("ints")->storage() == ListObject::Storage::INT);
+    assert(list("floats")->storage() == ListObject::Storage::FLOAT);
+    assert(list("mixed")->storage() == ListObject::Storage::GENERIC);
+    assert(list("empty")->storage() == ListObject::Storage::EMPTY);
+    assert(list("reused")->storage() == ListObject::Storage::FLOAT);
+
+    // Promotion keeps the existing elements
+    auto mixed = list("mixed");
+    assert(mixed->size() == 3);
+    assert(std::get<int64_t>(mixed->get(0)) == 1);
+    assert(std::get<caesar::String>(mixed->get(2)) == "x");
+
+    std::cout << "✓ List storage strategy tests passed\n";
+}
+
+void test_list_operations() {
+    std::cout << "Testing list operations...\n";
+
+    assert(std::get<int64_t>(run("[10, 20, 30][1]\n")) == 20);
+    assert(std::get<int64_t>(run("[10, 20, 30][-1]\n")) == 30);
+    assert(std::get<int64_t>(run("len([1, 2, 3])\n")) == 3);
+    assert(std::get<int64_t>(run("sum([1, 2, 3, 4])\n")) == 10);
+    assert(std::get<double>(run("sum([0.5, 0.25])\n")) == 0.75);
+    assert(std::get<double>(run("sum([1, 0.5])\n")) == 1.5);
+    assert(std::get<int64_t>(run("sum([])\n")) == 0);
+    assert(std::get<caesar::String>(run("str([1, \"a\", 2.5])\n")) == "[1, 'a', 2.500000]");
+    assert(std::get<caesar::String>(run("\"abc\"[-1]\n")) == "c");
+    // A list inside itself prints as [...], but one shared twice prints in full
+    assert(std::get<caesar::String>(run("a = [1]\na.append(a)\nstr(a)\n")) == "[1, [...]]");
+    assert(std::get<caesar::String>(run("b = [2]\nstr([b, b])\n")) == "[[2], [2]]");
+
+    std::string source = R"(
+a = [1, 2, 3]
+a[0] = 5
+a[-1] = "z"
+last = a.pop()
+first = a.pop(0)
+total = 0
+for x in [1, 2, 3]:
+    total = total + x
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    auto a = std::get<caesar::Ref<caesar::ListObject>>(env->get("a"));
+    assert(a->size() == 1 && std::get<int64_t>(a->get(0)) == 2);
+    assert(std::get<caesar::String>(env->get("last")) == "z");
+    assert(std::get<int64_t>(env->get("first")) == 5);
+    assert(std::get<int64_t>(env->get("total")) == 6);
+
+    assert(failsAtRuntime("[1, 2][2]\n"));
+    assert(failsAtRuntime("[1, 2][-3]\n"));
+    assert(failsAtRuntime("[1][\"0\"]\n"));
+    assert(failsAtRuntime("[].pop()\n"));
+    assert(failsAtRuntime("[1].push(2)\n"));
+    assert(failsAtRuntime("sum([1, \"a\"])\n"));
+
+    std::cout << "✓ List operation tests passed\n";
+}
+
+void test_dict_table() {
+    std::cout << "Testing dict hash table...\n";
+
+    caesar::DictObject dict;
+    for (int64_t i = 0; i < 10000; i++) {
+        dict.set(i, i * 2);
+    }
+    assert(dict.size() == 10000);
+    assert(std::get<int64_t>(*dict.find(int64_t(1234))) == 2468);
+    assert(dict.find(int64_t(10000)) == nullptr);
+
+    // 1, 1.0 and True are the same key
+    assert(std::get<int64_t>(*dict.find(caesar::Value(1.0))) == 2);
+    assert(std::get<int64_t>(*dict.find(caesar::Value(true))) == 2);
+    assert(dict.find(caesar::Value(1.5)) == nullptr);
+
+    // Removing leaves tombstones that lookups probe past
+    for (int64_t i = 0; i < 10000; i += 2) {
+        assert(dict.remove(i));
+    }
+    assert(!dict.remove(int64_t(0)));
+    assert(dict.size() == 5000);
+    assert(dict.find(int64_t(4)) == nullptr);
+    assert(std::get<int64_t>(*dict.find(int64_t(9999))) == 19998);
+
+    // Iteration order is insertion order, across the resize that drops tombstones
+    for (int64_t i = 10000; i < 20000; i++) {
+        dict.set(i, i);
+    }
+    int64_t previous = -1;
+    size_t live = 0;
+    for (const auto& entry : dict.entries()) {
+        if (!entry.live) continue;
+        int64_t key = std::get<int64_t>(entry.key);
+        assert(key > previous);
+        previous = key;
+        live++;
+    }
+    assert(live == dict.size() && live == 15000);
+
+    // String keys match by content, interned or not
+    caesar::DictObject names;
+    names.set(caesar::String::intern("key"), int64_t(1));
+    assert(names.find(caesar::String(std::string("k") + "ey")) != nullptr);
+    assert(names.find(caesar::String("other")) == nullptr);
+
+    std::cout << "✓ Dict hash table tests passed\n";
+}
+
+void test_dict_operations() {
+    std::cout << "Testing dict operations...\n";
+
+    assert(std::get<int64_t>(run("{\"a\": 1, \"b\": 2}[\"b\"]\n")) == 2);
+    assert(std::get<int64_t>(run("len({1: 2, 3: 4, 1: 5})\n")) == 2);
+    assert(std::get<caesar::String>(run("str({\"a\": 1, 2: \"b\"})\n")) == "{'a': 1, 2: 'b'}");
+    assert(std::get<int64_t>(run("{\"a\": 1}.get(\"z\", 7)\n")) == 7);
+    assert(std::holds_alternative<std::nullptr_t>(run("{}.get(1)\n")));
+    // Cycles through dicts, alone or mixed with lists, print as {...} and [...]
+    assert(std::get<caesar::String>(run("d = {}\nd[\"s\"] = d\nstr(d)\n")) == "{'s': {...}}");
+    assert(std::get<caesar::String>(run("d = {}\nd[1] = [d]\nstr(d)\n")) == "{1: [{...}]}");
+
+    std::string source = R"(
+d = {"x": 1}
+d["y"] = 2
+d["x"] = 3
+removed = d.pop("y")
+d["z"] = 4
+order = ""
+for k in d:
+    order = order + k
+keys = d.keys()
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    auto d = std::get<caesar::Ref<caesar::DictObject>>(env->get("d"));
+    assert(d->size() == 2);
+    assert(std::get<int64_t>(*d->find(caesar::String("x"))) == 3);
+    assert(std::get<int64_t>(env->get("removed")) == 2);
+    assert(std::get<caesar::String>(env->get("order")) == "xz");
+    assert(std::get<caesar::Ref<caesar::ListObject>>(env->get("keys"))->size() == 2);
+
+    assert(failsAtRuntime("{\"a\": 1}[\"b\"]\n"));
+    assert(failsAtRuntime("{}.pop(1)\n"));
+    assert(failsAtRuntime("d = {}\nd[[1]] = 2\n"));
+    assert(failsAtRuntime("d = {1: 1}\nfor k in d:\n    d[k + 1] = 1\n"));
+
+    std::cout << "✓ Dict operation tests passed\n";
+}
+
+void test_tail_calls() {
+    std::cout << "Testing tail call elimination...\n";
+
+    // Deep enough to overflow the native stack without frame reuse
+    std::string source = R"(
+def count(n, acc):
+    if n == 0:
+        return acc
+    return count(n - 1, acc + 1)
+
+def is_even(n):
+    if n == 0:
+        return 1
+    return is_odd(n - 1)
+
+def is_odd(n):
+    if n == 0:
+        return 0
+    return is_even(n - 1)
+
+def total(n):
+    if n == 0:
+        return 0
+    return n + total(n - 1)
+
+def size(items):
+    return len(items)
+
+counted = count(200000, 0)
+even = is_even(200001)
+summed = total(100)
+sized = size([1, 2, 3])
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    auto func = dynamic_cast<caesar::FunctionDefinition*>(program->statements[0].get());
+    auto body = dynamic_cast<caesar::BlockStatement*>(func->body.get());
+    auto ret = dynamic_cast<caesar::ReturnStatement*>(body->statements[1].get());
+    assert(ret != nullptr && ret->is_tail_call);
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    assert(std::get<int64_t>(env->get("counted")) == 200000);
+    assert(std::get<int64_t>(env->get("even")) == 0);
+    assert(std::get<int64_t>(env->get("summed")) == 5050);
+    assert(std::get<int64_t>(env->get("sized")) == 3);
+
+    assert(failsAtRuntime("def f(a):\n    return f(1, 2)\nf(0)\n"));
+
+    std::cout << "✓ Tail call elimination tests passed\n";
+}
+
+void test_call_frames() {
+    std::cout << "Testing call frames...\n";
+
+    // Returns unwind out of nested loops and blocks without exceptions
+    std::string source = R"(
+def find(items, target):
+    for x in items:
+        i = 0
+        while i < 3:
+            if x == target:
+                return x * 10
+            i = i + 1
+    return -1
+
+def depth(n):
+    if n == 0:
+        return 0
+    return 1 + depth(n - 1)
+
+found = find([1, 2, 3], 2)
+missing = find([1, 2, 3], 7)
+deep = depth(9000)
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    // 9000 nested calls overflow an 8 MB native stack; interpret() runs on its own
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    assert(std::get<int64_t>(env->get("found")) == 20);
+    assert(std::get<int64_t>(env->get("missing")) == -1);
+    assert(std::get<int64_t>(env->get("deep")) == 9000);
+    assert(interpreter.getCallDepth() == 0);
+
+    // Exceeding the limit is a RuntimeError that unwinds every frame
+    std::string recursive = R"(
+def forever(n):
+    return 1 + forever(n + 1)
+
+forever(0)
+)";
+    caesar::Lexer recursive_lexer(recursive);
+    caesar::Parser recursive_parser(recursive_lexer.tokenize());
+    auto recursive_program = recursive_parser.parse();
+
+    caesar::Interpreter limited;
+    limited.setMaxRecursion(100);
+    bool raised = false;
+    try {
+        recursive_program->accept(limited);
+    } catch (const caesar::RuntimeError& e) {
+        raised = std::string(e.what()).find("maximum recursion depth") != std::string::npos;
+    }
+    assert(raised);
+    assert(limited.getCallDepth() == 0);
+
+    std::cout << "✓ Call frame tests passed\n";
+}
+
+void test_call_allocations() {
+    std::cout << "Testing call allocations...\n";
+
+    // Allocations made by a program running n calls of a 4-argument function and a builtin
+    auto allocationsFor = [](const std::string& n) {
+        std::string source =
+            "def pick(a, b, c, d):\n"
+            "    x = a + b\n"
+            "    return x + c + d\n"
+            "total = 0\n"
+            "i = 0\n"
+            "while i < " + n + ":\n"
+            "    total = pick(i, 1, 2, 3)\n"
+            "    total = total + abs(-1)\n"
+            "    i = i + 1\n";
+        caesar::Lexer lexer(source);
+        caesar::Parser parser(lexer.tokenize());
+        auto program = parser.parse();
+
+        caesar::Interpreter interpreter;
+        size_t before = allocation_count;
+        interpreter.interpret(program.get());
+        return allocation_count - before;
+    };
+
+    // Same program text length, 100x the calls: the difference is the per-call cost.
+    // The first run allocates the memory pool's slabs and interns the program's names.
+    allocationsFor("00001");
+    size_t few = allocationsFor("00100");
+    size_t many = allocationsFor("10000");
+    assert(many == few);
+
+    caesar::SmallVector<caesar::Value, 2> values;
+    for (int64_t i = 0; i < 5; i++) {
+        values.push_back(i);
+    }
+    caesar::SmallVector<caesar::Value, 2> moved(std::move(values));
+    assert(values.empty() && moved.size() == 5);
+    assert(std::get<int64_t>(moved[4]) == 4);
+
+    std::cout << "✓ Call allocation tests passed\n";
+}
+
+void test_escape_analysis() {
+    std::cout << "Testing escape analysis...\n";
+
+    std::string source = R"(
+def make_counter(start):
+    count = start
+    def get():
+        return count
+    return get
+
+def plain(a, b=2):
+    total = a + b
+    for i in range(3):
+        total = total + i
+    def double(x):
+        return x * 2
+    return double(total)
+
+def recursive_helper(n):
+    def helper(k):
+        if k == 0:
+            return 0
+        return 1 + helper(k - 1)
+    return helper(n)
+
+g = 100
+def reads_global():
+    return g + 1
+
+counter = make_counter(5)
+r1 = counter()
+r2 = plain(1)
+r3 = recursive_helper(10)
+r4 = reads_global()
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    auto function = [&](size_t index) {
+        auto def = dynamic_cast<caesar::FunctionDefinition*>(program->statements[index].get());
+        assert(def != nullptr);
+        caesar::Resolver::resolve(*def);
+        return def;
+    };
+
+    // get() reads count, so only that local becomes a cell
+    auto counter = function(0);
+    assert(counter->slot_names.size() == 3);  // start, count, get
+    assert(counter->cell_slots.size() == 1 && counter->cell_slots[0] == 1);
+    auto plain = function(1);
+    assert(plain->cell_slots.empty());
+    assert(plain->slot_names.size() == 5);  // a, b, total, i, double
+    assert(plain->slot_names[0] == "a" && plain->slot_names[1] == "b");
+    assert(function(2)->cell_slots.size() == 1);  // helper, which calls itself
+    auto global_reader = function(4);
+    assert(global_reader->cell_slots.empty() && global_reader->upvalues.empty());
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    assert(std::get<int64_t>(env->get("r1")) == 5);
+    assert(std::get<int64_t>(env->get("r2")) == 12);
+    assert(std::get<int64_t>(env->get("r3")) == 10);
+    assert(std::get<int64_t>(env->get("r4")) == 101);
+
+    // Locals stay out of the global scope
+    assert(!env->exists("total") && !env->exists("double"));
+
+    std::cout << "✓ Escape analysis tests passed\n";
+}
+
+void test_upvalues() {
+    std::cout << "Testing upvalue capture...\n";
+
+    std::string source = R"(
+def outer():
+    big = [1, 2, 3]
+    label = "x"
+    def unused():
+        return 1
+    def reads_label():
+        return label
+    label = "y"
+    return [unused, reads_label]
+
+def level1(a):
+    b = a * 2
+    def level2():
+        def level3():
+            return a + b
+        return level3
+    return level2()
+
+def with_default(n):
+    step = 3
+    def add(x, by=step):
+        return x + by
+    return add(n)
+
+def counters():
+    made = []
+    for i in range(3):
+        def get():
+            return i
+        made.append(get)
+    return made
+
+pair = outer()
+r1 = pair[0]()
+r2 = pair[1]()
+r3 = level1(5)()
+r4 = with_default(4)
+made = counters()
+r5 = made[0]() + made[2]()
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    assert(std::get<int64_t>(env->get("r1")) == 1);
+    // The cell is shared, so later assignments in outer() are visible
+    assert(std::get<caesar::String>(env->get("r2")) == "y");
+    assert(std::get<int64_t>(env->get("r3")) == 15);
+    assert(std::get<int64_t>(env->get("r4")) == 7);
+    // Like Python, every closure made in the loop sees the final i
+    assert(std::get<int64_t>(env->get("r5")) == 4);
+
+    // Closures hold only the cells they reference, never the whole frame
+    auto pair = std::get<caesar::Ref<caesar::ListObject>>(env->get("pair"));
+    auto unused = std::get<caesar::Ref<caesar::CallableFunction>>(pair->get(0));
+    auto reads_label = std::get<caesar::Ref<caesar::CallableFunction>>(pair->get(1));
+    assert(unused->getUpvalueCount() == 0);
+    assert(reads_label->getUpvalueCount() == 1);
+
+    // level3 reaches a and b through level2, which captures them for it
+    auto level1 = dynamic_cast<caesar::FunctionDefinition*>(program->statements[1].get());
+    assert(level1->cell_slots.size() == 2);
+    auto level2 = dynamic_cast<caesar::FunctionDefinition*>(
+        dynamic_cast<caesar::BlockStatement*>(level1->body.get())->statements[1].get());
+    assert(level2 != nullptr && level2->upvalues.size() == 2);
+    assert(level2->upvalues[0].from_parent_local);
+
+    std::cout << "✓ Upvalue capture tests passed\n";
+}
+
+void test_unbound_locals() {
+    std::cout << "Testing reads of unassigned locals...\n";
+
+    // Assigning anywhere in a function makes the name local to all of it, but
+    // until then reads see the same name in the enclosing functions or globals
+    std::string source = R"(
+count = 0
+def bump():
+    count = count + 1
+    return count
+
+def outer():
+    y = 1
+    def inner():
+        y = y + 1
+        return y
+    return [inner(), y]
+
+def deep():
+    v = 10
+    def middle():
+        def innermost():
+            v = v + 1
+            return v
+        return innermost()
+    return middle()
+
+x = "global"
+def late():
+    def read():
+        return x
+    before = read()
+    x = "outer"
+    return [before, read()]
+
+r1 = bump()
+r2 = outer()
+r3 = deep()
+r4 = late()
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+
+    auto env = interpreter.getCurrentEnvironment();
+    assert(std::get<int64_t>(env->get("r1")) == 1);
+    // The assignments made new locals, so the variables read stay unchanged
+    assert(std::get<int64_t>(env->get("count")) == 0);
+    auto r2 = std::get<caesar::Ref<caesar::ListObject>>(env->get("r2"));
+    assert(std::get<int64_t>(r2->get(0)) == 2 && std::get<int64_t>(r2->get(1)) == 1);
+    assert(std::get<int64_t>(env->get("r3")) == 11);
+    // A captured variable not assigned yet reads the global
+    auto r4 = std::get<caesar::Ref<caesar::ListObject>>(env->get("r4"));
+    assert(std::get<caesar::String>(r4->get(0)) == "global");
+    assert(std::get<caesar::String>(r4->get(1)) == "outer");
+
+    // A name assigned nowhere readable is still undefined
+    assert(failsAtRuntime("def f():\n    print(n)\n    n = 1\nf()\n"));
+
+    // Builtins take precedence over globals, parameters and locals alike
+    assert(std::get<caesar::String>(run("len = 5\nlen\n")) == "__builtin_len");
+    assert(std::get<caesar::String>(run("def f(len):\n    return len\nf(3)\n")) == "__builtin_len");
+    assert(std::get<int64_t>(run("def f():\n    abs = 7\n    return abs(-2)\nf()\n")) == 2);
+
+    std::cout << "✓ Unbound local tests passed\n";
+}
+
+void test_ref_counting() {
+    std::cout << "Testing reference counting...\n";
+
+    caesar::GcHeap& heap = caesar::GcHeap::instance();
+    size_t baseline = heap.trackedCount();
+    {
+        auto list = caesar::makeRef<caesar::ListObject>();
+        assert(list->refCount() == 1);
+
+        caesar::Value value = list;
+        caesar::Ref<caesar::ListObject> copy = list;
+        assert(list->refCount() == 3);
+
+        // Self-assignment must not free the object
+        copy = copy;
+        copy = std::move(copy);
+        assert(list->refCount() == 3);
+
+        caesar::Ref<caesar::GcObject> base = list;
+        assert(base.get() == list.get() && list->refCount() == 4);
+        base.reset();
+        value = nullptr;
+        assert(list->refCount() == 2);
+    }
+    assert(heap.trackedCount() == baseline);
+
+    // Calls move their arguments into registers, and evaluate() moves its result
+    auto value = run("items = [1]\ndef keep(xs):\n    return xs\nkept = keep(items)\nkept");
+    auto list = std::get<caesar::Ref<caesar::ListObject>>(value);
+    assert(list->size() == 1);
+
+    std::cout << "✓ Reference counting tests passed\n";
+}
+
+void test_cycle_collection() {
+    std::cout << "Testing cycle collection...\n";
+
+    caesar::GcHeap& heap = caesar::GcHeap::instance();
+    heap.collect();
+    size_t baseline = heap.trackedCount();
+
+    {
+        std::string source = R"(
+def make(n):
+    def f():
+        return f
+    items = [n]
+    items.append(items)
+    table = {"self": None}
+    table["self"] = table
+    return n
+
+for i in range(50):
+    make(i)
+
+kept = [1, 2]
+kept.append(kept)
+)";
+        caesar::Lexer lexer(source);
+        caesar::Parser parser(lexer.tokenize());
+        auto program = parser.parse();
+
+        caesar::Interpreter interpreter;
+        interpreter.interpret(program.get());
+
+        // Each call left a function/cell cycle, a list cycle and a dict cycle
+        size_t freed = heap.collect();
+        assert(freed >= 50 * 4);
+
+        // Cycles still reachable from the globals survive
+        auto env = interpreter.getCurrentEnvironment();
+        auto kept = std::get<caesar::Ref<caesar::ListObject>>(env->get("kept"));
+        assert(kept->size() == 3);
+        assert(std::get<int64_t>(kept->get(1)) == 2);
+    }
+
+    // Destroying the interpreter reclaims the globals and top-level functions
+    assert(heap.trackedCount() == baseline);
+
+    // Objects owned by no Ref are always treated as live
+    caesar::ListObject local;
+    local.append(static_cast<int64_t>(1));
+    heap.collect();
+    assert(local.size() == 1);
+
+    std::cout << "✓ Cycle collection tests passed\n";
+}
+
+void test_gc_generations() {
+    std::cout << "Testing GC generations...\n";
+
+    caesar::GcHeap& heap = caesar::GcHeap::instance();
+    heap.collect();
+    size_t old_count = heap.generationCount(caesar::GcHeap::OLD);
+
+    // A live object and a dead cycle, both young
+    auto survivor = caesar::makeRef<caesar::ListObject>();
+    survivor->append(static_cast<int64_t>(7));
+    {
+        auto cycle = caesar::makeRef<caesar::ListObject>();
+        cycle->append(cycle);
+    }
+    assert(heap.generationCount(caesar::GcHeap::YOUNG) == 2);
+
+    // A young collection frees the cycle and promotes the survivor
+    assert(heap.collectYoung() == 1);
+    assert(heap.generationCount(caesar::GcHeap::YOUNG) == 0);
+    assert(heap.generationCount(caesar::GcHeap::OLD) == old_count + 1);
+
+    // An old object referencing a young cycle keeps it alive until it dies
+    auto young = caesar::makeRef<caesar::ListObject>();
+    young->append(young);
+    survivor->append(young);
+    young.reset();
+    assert(heap.collectYoung() == 0);
+    survivor->pop(1);
+    assert(heap.collect() == 1);
+    assert(std::get<int64_t>(survivor->get(0)) == 7);
+
+    std::cout << "✓ GC generation tests passed\n";
+}
+
+void test_incremental_gc() {
+    std::cout << "Testing incremental GC...\n";
+
+    caesar::GcHeap& heap = caesar::GcHeap::instance();
+    heap.collect();
+
+    // Enough old self-referencing lists to make a full collection due
+    std::vector<caesar::Ref<caesar::ListObject>> lists;
+    for (int64_t i = 0; i < 12000; i++) {
+        auto list = caesar::makeRef<caesar::ListObject>();
+        list->append(i);
+        list->append(list);
+        lists.push_back(list);
+    }
+    heap.collectYoung();
+    assert(heap.generationCount(caesar::GcHeap::YOUNG) == 0);
+
+    // Drop every other list; only its own cycle keeps it alive now
+    for (size_t i = 1; i < lists.size(); i += 2) {
+        lists[i].reset();
+    }
+    size_t tracked = heap.trackedCount();
+
+    heap.setMaxPause(std::chrono::microseconds(1));
+    size_t freed = heap.collectYoung();
+
+    // Between slices, move the only reference to a live list into another one
+    auto holder = caesar::makeRef<caesar::ListObject>();
+    holder->append(lists[0]);
+    lists[0].reset();
+
+    while (heap.cycleInProgress()) {
+        freed += heap.collectYoung();
+    }
+    heap.setMaxPause(std::chrono::microseconds(0));
+
+    assert(freed == 6000);
+    assert(heap.trackedCount() == tracked - 6000 + 1);  // Plus the holder
+    auto moved = std::get<caesar::Ref<caesar::ListObject>>(holder->get(0));
+    assert(std::get<int64_t>(moved->get(0)) == 0);
+    assert(std::get<int64_t>(lists[2]->get(0)) == 2);
+
+    std::cout << "✓ Incremental GC tests passed\n";
+}
+
+void test_memory_pool() {
+    std::cout << "Testing memory pool...\n";
+
+    caesar::MemoryPool& pool = caesar::MemoryPool::instance();
+
+    // A freed block is the next one handed out for its size class
+    uint64_t allocations = pool.classStats(40).allocations;
+    uint64_t live = pool.classStats(40).liveBlocks();
+    void* first = pool.allocate(40);
+    pool.deallocate(first, 40);
+    void* second = pool.allocate(48);
+    assert(second == first);
+    assert(pool.classStats(40).allocations == allocations + 2);
+    assert(pool.classStats(40).liveBlocks() == live + 1);
+    pool.deallocate(second, 48);
+
+    // Larger requests bypass the size classes
+    uint64_t large = pool.classStats(1000).allocations;
+    void* block = pool.allocate(1000);
+    assert(pool.classStats(1000).allocations == large + 1);
+    assert(pool.classStats(1000).liveBlocks() > 0);
+    pool.deallocate(block, 1000);
+
+    // Runtime objects come from the pool
+    uint64_t list_allocations = pool.classStats(sizeof(caesar::ListObject)).allocations;
+    auto list = caesar::makeRef<caesar::ListObject>();
+    assert(pool.classStats(sizeof(caesar::ListObject)).allocations == list_allocations + 1);
+
+    std::cout << "✓ Memory pool tests passed\n";
+}
+
+void test_sampling_profiler() {
+    std::cout << "Testing sampling profiler...\n";
+
+    std::string definitions = R"(
+def inner():
+    x = 1
+    return x
+
+def outer():
+    y = inner()
+    return y
+)";
+    caesar::Lexer lexer(definitions);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+    caesar::Lexer call_lexer("outer()\n");
+    caesar::Parser call_parser(call_lexer.tokenize());
+    auto call = call_parser.parse();
+
+    caesar::SamplingProfiler profiler;
+    caesar::Interpreter interpreter;
+    interpreter.interpret(program.get());
+    interpreter.setProfiler(&profiler);
+
+    // Ticks taken so far are recorded at the first poll, after inner's first statement
+    caesar::SamplingProfiler::tick();
+    caesar::SamplingProfiler::tick();
+    caesar::SamplingProfiler::tick();
+    interpreter.interpret(call.get());
+    assert(profiler.sampleCount() == 3);
+
+    std::ostringstream folded;
+    profiler.writeFolded(folded);
+    assert(folded.str() == "<module>:1;outer:7;inner:3 3\n");
+
+    std::cout << "✓ Sampling profiler tests passed\n";
+}
+
+void test_function_profiler() {
+    std::cout << "Testing function profiler...\n";
+
+    std::string source = R"(
+def depth(n):
+    if n == 0:
+        return len([1, 2])
+    return depth(n - 1) + 1
+
+def countdown(n):
+    if n == 0:
+        return 0
+    return countdown(n - 1)
+
+def run():
+    total = countdown(4)
+    for i in range(3):
+        total = total + depth(4)
+    return total
+
+result = run()
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::FunctionProfiler timer;
+    caesar::Interpreter interpreter;
+    interpreter.setFunctionProfiler(&timer);
+    interpreter.interpret(program.get());
+    assert(std::get<int64_t>(interpreter.getCurrentEnvironment()->get("result")) == 18);
+
+    std::unordered_map<std::string, const caesar::FunctionProfiler::FunctionStats*> stats;
+    for (const auto* function : timer.sortedStats()) {
+        stats[function->name] = function;
+    }
+    assert(stats.size() == 5);
+    assert(stats["run"]->calls == 1);
+    assert(stats["range"]->calls == 1);
+    assert(stats["len"]->calls == 3);
+
+    // Recursion only counts the time of the outermost activation
+    const auto* depth = stats["depth"];
+    assert(depth->calls == 15);
+    assert(depth->outermost_calls == 3);
+    assert(depth->self <= depth->total);
+    assert(depth->total <= stats["run"]->total);
+
+    // A tail call replaces its caller, so each one starts a new outermost call
+    const auto* countdown = stats["countdown"];
+    assert(countdown->calls == 5);
+    assert(countdown->outermost_calls == 5);
+    assert(stats["run"]->self + countdown->total + depth->total +
+           stats["range"]->total <= stats["run"]->total);
+
+    std::cout << "✓ Function profiler tests passed\n";
+}
+
+void test_execution_stats() {
+    std::cout << "Testing execution stats...\n";
+
+    std::string source = R"(
+total = 0
+for i in range(3):
+    total = total + i
+half = total + 0.5
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::ExecutionStats stats;
+    caesar::CountingInterpreter interpreter(stats);
+    interpreter.interpret(program.get());
+    assert(std::get<double>(interpreter.getCurrentEnvironment()->get("half")) == 3.5);
+
+    using caesar::NodeKind;
+    assert(stats.visits(NodeKind::PROGRAM) == 1);
+    assert(stats.visits(NodeKind::FOR) == 1);
+    assert(stats.visits(NodeKind::BINARY) == 4);
+    assert(stats.visits(NodeKind::ASSIGNMENT) == 5);
+    assert(stats.visitPairs(NodeKind::BINARY, NodeKind::IDENTIFIER) == 4);
+
+    // Value alternatives: int is index 2, float index 3
+    assert(stats.binaryOperands(caesar::TokenType::PLUS, 2, 2) == 3);
+    assert(stats.binaryOperands(caesar::TokenType::PLUS, 2, 3) == 1);
+    assert(stats.specializations(caesar::BinarySpecialization::UNSPECIALIZED,
+                                 caesar::BinarySpecialization::INT_INT) == 1);
+    assert(stats.specializations(caesar::BinarySpecialization::UNSPECIALIZED,
+                                 caesar::BinarySpecialization::NUMERIC) == 1);
+
+    std::ostringstream json;
+    stats.writeJson(json);
+    assert(json.str().find("\"BinaryExpression\": 4") != std::string::npos);
+    assert(json.str().find("{\"operator\": \"PLUS\", \"left\": \"int\", \"right\": \"float\", "
+                           "\"count\": 1}") != std::string::npos);
+
+    std::cout << "✓ Execution stats tests passed\n";
+}
+
+void test_tracer() {
+    std::cout << "Testing tracer...\n";
+
+    std::string source = R"(
+def countdown(n):
+    if n == 0:
+        return len([1])
+    return countdown(n - 1)
+
+result = 0
+while result < 2:
+    result = result + countdown(2)
+)";
+    caesar::Lexer lexer(source);
+    caesar::Parser parser(lexer.tokenize());
+    auto program = parser.parse();
+
+    caesar::Tracer tracer(64, true);
+    caesar::Interpreter interpreter;
+    interpreter.setTracer(&tracer);
+    interpreter.interpret(program.get());
+    assert(std::get<int64_t>(interpreter.getCurrentEnvironment()->get("result")) == 2);
+
+    // One loop; per iteration three countdown slices (tail calls replace their caller) and one len
+    assert(tracer.recordedCount() == 2 + 2 * (3 + 1) * 2);
+    assert(tracer.droppedCount() == 0);
+
+    std::ostringstream json;
+    tracer.writeJson(json);
+    std::string trace = json.str();
+    assert(trace.rfind("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", 0) == 0);
+    assert(trace.find("{\"name\": \"while line 8\", \"cat\": \"loop\", \"ph\": \"B\"") != std::string::npos);
+    // Builtins are named as the program calls them, not by their internal reference
+    assert(trace.find("{\"name\": \"len\", \"cat\": \"builtin\", \"ph\": \"B\"") != std::string::npos);
+    assert(trace.find("__builtin_") == std::string::npos);
+
+    // A full buffer keeps the newest events and drops ends whose begin was overwritten
+    caesar::Tracer small(4);
+    small.begin("outer", caesar::TraceCategory::FUNCTION);
+    small.begin("a", caesar::TraceCategory::FUNCTION);
+    small.end(caesar::TraceCategory::FUNCTION);
+    small.begin("b", caesar::TraceCategory::FUNCTION);
+    small.end(caesar::TraceCategory::FUNCTION);
+    small.end(caesar::TraceCategory::FUNCTION);
+    assert(small.capacity() == 4);
+    assert(small.droppedCount() == 2);
+
+    std::ostringstream small_json;
+    small.writeJson(small_json);
+    std::string kept = small_json.str();
+    assert(kept.find("\"b\"") != std::string::npos);
+    assert(kept.find("\"outer\"") == std::string::npos);
+    size_t ends = 0;
+    for (size_t at = kept.find("\"ph\": \"E\""); at != std::string::npos; at = kept.find("\"ph\": \"E\"", at + 1)) {
+        ends++;
+    }
+    assert(ends == 1);
+
+    std::cout << "✓ Tracer tests passed\n";
+}
+
+int main() {
+    std::cout << "Running Caesar interpreter tests...\n\n";
+
+    try {
+        test_binary_arithmetic();
+        test_binary_specialization();
+        test_binary_deoptimization();
+        test_string_concatenation();
+        test_string_interning();
+        test_list_storage_strategies();
+        test_list_operations();
+        test_dict_table();
+        test_dict_operations();
+        test_tail_calls();
+        test_call_frames();
+        test_call_allocations();
+        test_escape_analysis();
+        test_upvalues();
+        test_unbound_locals();
+        test_ref_counting();
+        test_cycle_collection();
+        test_gc_generations();
+        test_incremental_gc();
+        test_memory_pool();
+        test_sampling_profiler();
+        test_function_profiler();
+        test_execution_stats();
+        test_tracer();
+
+        std::cout << "\n✅ All interpreter tests passed!\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "\n❌ Interpreter test failed: " << e.what() << "\n";
+        return 1;
+    }
+}